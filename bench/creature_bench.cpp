@@ -0,0 +1,226 @@
+#include "towerdefense/CreatureGrid.hpp"
+#include "towerdefense/CreatureStore.hpp"
+#include "towerdefense/Map.hpp"
+#include "towerdefense/MovementKernel.hpp"
+#include "towerdefense/Route.hpp"
+#include "towerdefense/Tower.hpp"
+#include "towerdefense/TowerCoverage.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace towerdefense;
+
+namespace {
+
+constexpr std::uint8_t kRouted = 1;
+
+// Movement state for a crowd: a tenth are dead, a few have no route, about
+// a third start slowed.
+struct Crowd {
+    std::vector<double> progress;
+    std::vector<double> speed;
+    std::vector<double> slow_factor;
+    std::vector<int> slow_duration;
+    std::vector<int> health;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint32_t> steps;
+
+    explicit Crowd(std::size_t count)
+        : progress(count)
+        , speed(count)
+        , slow_factor(count, 1.0)
+        , slow_duration(count, 0)
+        , health(count)
+        , flags(count, kRouted)
+        , steps(count) {
+        std::uint64_t state = 99;
+        auto next = [&state] {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<std::uint32_t>(state >> 33);
+        };
+        for (std::size_t i = 0; i < count; ++i) {
+            speed[i] = 0.05 + static_cast<double>(next() % 1000) / 4000.0;
+            progress[i] = static_cast<double>(next() % 1000) / 1000.0;
+            health[i] = next() % 10 == 0 ? 0 : 10 + static_cast<int>(next() % 40);
+            if (next() % 3 == 0) {
+                slow_factor[i] = 0.4 + static_cast<double>(next() % 50) / 100.0;
+                slow_duration[i] = static_cast<int>(next() % 60);
+            }
+            if (next() % 50 == 0) {
+                flags[i] = 0;
+            }
+        }
+    }
+
+    [[nodiscard]] MovementLanes lanes() {
+        return MovementLanes{progress.data(), speed.data(), slow_factor.data(), slow_duration.data(), health.data(),
+            flags.data(), kRouted, progress.size()};
+    }
+};
+
+// Runs ticks movement ticks, stepping every creature that reached a new
+// cell back by one. Returns milliseconds and the total steps taken.
+double run_ticks(Crowd& crowd, MovementKernel kernel, int ticks, std::size_t& steps_taken) {
+    const MovementLanes lanes = crowd.lanes();
+    const auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        const std::size_t stepping = advance_movement(lanes, crowd.steps.data(), kernel);
+        for (std::size_t k = 0; k < stepping; ++k) {
+            crowd.progress[crowd.steps[k]] -= 1.0;
+        }
+        steps_taken += stepping;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+template <typename T>
+bool same_bits(const std::vector<T>& a, const std::vector<T>& b) {
+    return std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+void run_movement(std::size_t count, int ticks) {
+    Crowd scalar{count};
+    Crowd vector{count};
+    std::size_t scalar_steps = 0;
+    std::size_t vector_steps = 0;
+    const double scalar_ms = run_ticks(scalar, MovementKernel::Scalar, ticks, scalar_steps);
+    const double vector_ms = run_ticks(vector, MovementKernel::Avx2, ticks, vector_steps);
+    const bool identical = scalar_steps == vector_steps && same_bits(scalar.progress, vector.progress)
+        && same_bits(scalar.slow_factor, vector.slow_factor) && same_bits(scalar.slow_duration, vector.slow_duration);
+
+    const double updates = static_cast<double>(count) * ticks;
+    std::cout << std::setw(12) << count << std::fixed << std::setprecision(2) << std::setw(14)
+              << scalar_ms * 1e6 / updates << std::setw(14) << vector_ms * 1e6 / updates << std::setw(10)
+              << scalar_ms / vector_ms << std::setw(12) << (identical ? "yes" : "NO") << '\n';
+}
+
+// The range scan towers used before the creature grid: every creature,
+// with a square root per distance.
+void scan_in_radius(const CreatureStore& creatures, const GridPosition& origin, double radius, std::vector<std::size_t>& out) {
+    out.clear();
+    for (std::size_t i = 0; i < creatures.slot_count(); ++i) {
+        if (creatures.is_alive(i) && !creatures.has_exited(i) && distance(origin, creatures.position(i)) <= radius) {
+            out.push_back(i);
+        }
+    }
+}
+
+// Path corridors every sixth row and eighth column, the rest open ground.
+Map corridor_map(std::size_t size) {
+    Map::Grid grid(size * size, TileType::Empty);
+    for (std::size_t y = 0; y < size; ++y) {
+        for (std::size_t x = 0; x < size; ++x) {
+            if (y % 6 == 0 || x % 8 == 0) {
+                grid[y * size + x] = TileType::Path;
+            }
+        }
+    }
+    return Map{size, size, std::move(grid)};
+}
+
+// Creatures in range gathered from the cells a tower covers, as Tower does.
+void gather_covered(const CreatureStore& creatures, const CreatureGrid& grid, const TowerCoverage& coverage,
+    std::vector<std::size_t>& out) {
+    out.clear();
+    for (const auto& cell : coverage.by_distance()) {
+        for (const std::uint32_t index : grid.occupants(cell.cell)) {
+            if (creatures.is_alive(index)) {
+                out.push_back(index);
+            }
+        }
+    }
+}
+
+// One tick of range queries from every tower over a crowd spread along the
+// corridors of a size x size map: the full scan, the bucketed grid query,
+// and the per-tower coverage lists over the grid's cell occupancy.
+void run_targeting(std::size_t size, std::size_t tower_count, std::size_t creature_count, int ticks) {
+    std::uint64_t state = 7;
+    auto next = [&state] {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<std::size_t>(state >> 33);
+    };
+    const Map map = corridor_map(size);
+    CreatureStore creatures;
+    while (creatures.size() < creature_count) {
+        const GridPosition position{next() % size, next() % size};
+        if (!map.is_walkable(position)) {
+            continue;
+        }
+        Creature creature{"bench", "Bench", 10, 1.0, Materials{}};
+        creature.assign_path(Route::from_positions({position}));
+        creatures.push(std::move(creature));
+    }
+    std::vector<std::pair<GridPosition, double>> towers;
+    std::vector<TowerCoverage> coverage(tower_count);
+    for (std::size_t i = 0; i < tower_count; ++i) {
+        towers.emplace_back(GridPosition{next() % size, next() % size}, 2.5 + static_cast<double>(next() % 3));
+        coverage[i].build(map, towers[i].first, towers[i].second, 0);
+    }
+
+    std::vector<std::size_t> out;
+    std::size_t scan_hits = 0;
+    const auto scan_begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (const auto& [position, range] : towers) {
+            scan_in_radius(creatures, position, range, out);
+            scan_hits += out.size();
+        }
+    }
+    const auto grid_begin = std::chrono::steady_clock::now();
+    CreatureGrid grid{size, size};
+    std::size_t grid_hits = 0;
+    for (int t = 0; t < ticks; ++t) {
+        grid.rebuild(creatures, map);
+        for (const auto& [position, range] : towers) {
+            grid.query(creatures, position, range, out);
+            grid_hits += out.size();
+        }
+    }
+    const auto coverage_begin = std::chrono::steady_clock::now();
+    std::size_t coverage_hits = 0;
+    for (int t = 0; t < ticks; ++t) {
+        grid.rebuild(creatures, map);
+        for (const auto& covered : coverage) {
+            gather_covered(creatures, grid, covered, out);
+            coverage_hits += out.size();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    auto per_tick = [ticks](auto from, auto to) {
+        return std::chrono::duration<double, std::milli>(to - from).count() / ticks;
+    };
+    const double scan_ms = per_tick(scan_begin, grid_begin);
+    const double grid_ms = per_tick(grid_begin, coverage_begin);
+    const double coverage_ms = per_tick(coverage_begin, end);
+    const bool same = scan_hits == grid_hits && scan_hits == coverage_hits;
+    std::cout << std::setw(8) << tower_count << std::setw(11) << creature_count << std::fixed << std::setprecision(3)
+              << std::setw(12) << scan_ms << std::setw(12) << grid_ms << std::setw(12) << coverage_ms
+              << std::setw(10) << (same ? "yes" : "NO") << '\n';
+}
+
+} // namespace
+
+int main() {
+    const bool has_avx2 = best_movement_kernel() == MovementKernel::Avx2;
+    std::cout << "movement kernel (" << (has_avx2 ? "avx2 available" : "avx2 unavailable, both columns scalar") << ")\n"
+              << std::setw(12) << "creatures" << std::setw(14) << "scalar ns" << std::setw(14) << "avx2 ns"
+              << std::setw(10) << "speedup" << std::setw(12) << "identical" << '\n';
+    run_movement(10000, 2000);
+    run_movement(100000, 200);
+
+    std::cout << "\ntower range queries per tick (128x128)\n"
+              << std::setw(8) << "towers" << std::setw(11) << "creatures" << std::setw(12) << "scan ms"
+              << std::setw(12) << "grid ms" << std::setw(12) << "cover ms" << std::setw(10) << "same" << '\n';
+    run_targeting(128, 50, 1000, 50);
+    run_targeting(128, 200, 5000, 20);
+    return 0;
+}
@@ -0,0 +1,450 @@
+#include "towerdefense/Map.hpp"
+#include "towerdefense/PathFinder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace towerdefense;
+
+namespace {
+
+constexpr std::array<std::pair<int, int>, 4> directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+
+// The search PathFinder used before the flat-buffer core: a std::queue and a
+// hashed came_from map allocated for every query.
+std::optional<std::vector<GridPosition>> legacy_bfs(const Map& map, const GridPosition& start, const GridPosition& goal) {
+    if (!map.is_walkable(start) || !map.is_walkable(goal)) {
+        return std::nullopt;
+    }
+    std::queue<GridPosition> frontier;
+    std::unordered_map<std::size_t, GridPosition> came_from;
+    auto encode = [&map](const GridPosition& pos) { return pos.y * map.width() + pos.x; };
+    frontier.push(start);
+    came_from.emplace(encode(start), start);
+    while (!frontier.empty()) {
+        const auto current = frontier.front();
+        frontier.pop();
+        if (current == goal) {
+            break;
+        }
+        for (const auto& [dx, dy] : directions) {
+            const int next_x = static_cast<int>(current.x) + dx;
+            const int next_y = static_cast<int>(current.y) + dy;
+            if (next_x < 0 || next_y < 0) {
+                continue;
+            }
+            const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
+            if (!map.is_within_bounds(next) || !map.is_walkable(next)) {
+                continue;
+            }
+            const auto encoded = encode(next);
+            if (came_from.find(encoded) != came_from.end()) {
+                continue;
+            }
+            frontier.push(next);
+            came_from.emplace(encoded, current);
+        }
+    }
+    if (came_from.find(encode(goal)) == came_from.end()) {
+        return std::nullopt;
+    }
+    std::vector<GridPosition> path;
+    GridPosition current = goal;
+    while (current != start) {
+        path.push_back(current);
+        current = came_from.at(encode(current));
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// Serpentine corridors: every path tile is on the single route.
+std::vector<std::string> serpentine_lines(std::size_t size) {
+    std::vector<std::string> lines(size, std::string(size, '.'));
+    for (std::size_t y = 1; y + 1 < size; y += 2) {
+        for (std::size_t x = 1; x + 1 < size; ++x) {
+            lines[y][x] = '#';
+        }
+        const std::size_t link_x = ((y / 2) % 2 == 0) ? size - 2 : 1;
+        if (y + 2 < size - 1) {
+            lines[y + 1][link_x] = '#';
+        }
+    }
+    lines[1][0] = 'E';
+    std::size_t last_row = 1;
+    while (last_row + 2 < size - 1) {
+        last_row += 2;
+    }
+    lines[last_row][((last_row / 2) % 2 == 0) ? size - 2 : 1] = 'R';
+    return lines;
+}
+
+// Open field with a lattice of blocked pillars.
+std::vector<std::string> open_field_lines(std::size_t size) {
+    std::vector<std::string> lines(size, std::string(size, '#'));
+    for (std::size_t y = 2; y + 2 < size; y += 4) {
+        for (std::size_t x = 2; x + 2 < size; x += 4) {
+            lines[y][x] = 'B';
+        }
+    }
+    lines[0][0] = 'E';
+    lines[size - 1][size - 1] = 'R';
+    return lines;
+}
+
+// Large empty rooms separated by walls with a single gap each.
+std::vector<std::string> rooms_lines(std::size_t size) {
+    std::vector<std::string> lines(size, std::string(size, '#'));
+    for (std::size_t wall = size / 4; wall < size; wall += size / 4) {
+        for (std::size_t i = 0; i < size; ++i) {
+            lines[wall][i] = 'B';
+            lines[i][wall] = 'B';
+        }
+    }
+    for (std::size_t wall = size / 4; wall < size; wall += size / 4) {
+        for (std::size_t room = size / 8; room < size; room += size / 4) {
+            lines[wall][room] = '#';
+            lines[room][wall] = '#';
+        }
+    }
+    lines[0][0] = 'E';
+    lines[size - 1][size - 1] = 'R';
+    return lines;
+}
+
+// Turns the last path tile of a few evenly spaced rows into exits, so every
+// generated layout gets several reachable ones.
+std::vector<std::string> with_exits(std::vector<std::string> lines) {
+    const std::size_t size = lines.size();
+    for (std::size_t row = size / 8; row < size; row += size / 4) {
+        for (std::size_t y = row; y < size; ++y) {
+            const auto x = lines[y].rfind('#');
+            if (x != std::string::npos) {
+                lines[y][x] = 'X';
+                break;
+            }
+        }
+    }
+    return lines;
+}
+
+struct Query {
+    GridPosition start;
+    GridPosition goal;
+};
+
+template <typename Search>
+double time_queries(const std::vector<Query>& queries, int repetitions, Search&& search, std::size_t& checksum) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (const auto& query : queries) {
+            if (auto path = search(query)) {
+                checksum += path->size();
+            }
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - begin).count() / static_cast<double>(queries.size() * repetitions);
+}
+
+void run_case(const std::string& label, const Map& map, int repetitions) {
+    std::vector<Query> queries;
+    for (const auto& entry : map.entries()) {
+        queries.push_back({entry, map.resource_position()});
+    }
+    for (const auto& exit : map.exits()) {
+        queries.push_back({map.resource_position(), exit});
+    }
+
+    std::size_t legacy_checksum = 0;
+    const double legacy_us = time_queries(queries, repetitions,
+        [&](const Query& query) { return legacy_bfs(map, query.start, query.goal); }, legacy_checksum);
+
+    // A zero cache budget makes every query search again.
+    PathFinder finder{map, 0, PathFinder::Strategy::Flat};
+    std::size_t current_checksum = 0;
+    const double current_us = time_queries(queries, repetitions,
+        [&](const Query& query) { return finder.shortest_path(query.start, query.goal); }, current_checksum);
+
+    PathFinder jumper{map, 0, PathFinder::Strategy::JumpPoint};
+    std::size_t jump_checksum = 0;
+    const double jump_us = time_queries(queries, repetitions,
+        [&](const Query& query) { return jumper.shortest_path(query.start, query.goal); }, jump_checksum);
+
+    const bool lengths_match = legacy_checksum == current_checksum && legacy_checksum == jump_checksum;
+    std::cout << std::left << std::setw(28) << label << std::right << std::setw(7) << map.width() << 'x' << std::left
+              << std::setw(6) << map.height() << std::right << std::fixed << std::setprecision(2) << std::setw(12)
+              << legacy_us << std::setw(12) << current_us << std::setw(12) << jump_us << std::setw(9)
+              << legacy_us / current_us << 'x' << std::setw(9) << legacy_us / jump_us << 'x'
+              << (lengths_match ? "" : "  (path length mismatch!)") << '\n';
+}
+
+// Replays random walkable start cells towards the resource under a range of
+// cache budgets and reports how the LRU behaves.
+void run_cache_sizing(const Map& map) {
+    std::vector<GridPosition> walkable;
+    for (std::size_t y = 0; y < map.height(); ++y) {
+        for (std::size_t x = 0; x < map.width(); ++x) {
+            if (map.is_walkable(GridPosition{x, y})) {
+                walkable.push_back(GridPosition{x, y});
+            }
+        }
+    }
+    if (walkable.empty()) {
+        return;
+    }
+    std::vector<GridPosition> starts;
+    std::size_t state = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        starts.push_back(walkable[(state >> 33) % std::min<std::size_t>(walkable.size(), 64)]);
+    }
+
+    std::cout << "\ncache sizing (" << map.width() << 'x' << map.height() << ", " << starts.size() << " queries)\n";
+    std::cout << std::setw(12) << "budget KiB" << std::setw(10) << "hits" << std::setw(10) << "misses" << std::setw(11)
+              << "evictions" << std::setw(12) << "used KiB" << '\n';
+    for (const std::size_t budget_kib : {64u, 512u, 4096u, 32768u}) {
+        PathFinder finder{map, budget_kib * 1024, PathFinder::Strategy::Flat};
+        for (const auto& start : starts) {
+            (void)finder.shortest_path(start, map.resource_position());
+        }
+        const auto& stats = finder.cache_stats();
+        std::cout << std::setw(12) << budget_kib << std::setw(10) << stats.hits << std::setw(10) << stats.misses
+                  << std::setw(11) << stats.evictions << std::setw(12) << finder.cache_memory_usage() / 1024 << '\n';
+    }
+}
+
+// Flood fill from the entries the way prune_unused_paths used to run it,
+// against the word-parallel Map::reachable_from.
+void run_reachability(const std::string& label, const Map& map, int repetitions) {
+    std::size_t queue_cells = 0;
+    const auto queue_begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        std::vector<std::vector<bool>> visited(map.height(), std::vector<bool>(map.width(), false));
+        std::queue<GridPosition> frontier;
+        for (const auto& entry : map.entries()) {
+            frontier.push(entry);
+            visited[entry.y][entry.x] = true;
+        }
+        while (!frontier.empty()) {
+            const auto current = frontier.front();
+            frontier.pop();
+            ++queue_cells;
+            for (const auto& [dx, dy] : directions) {
+                const int next_x = static_cast<int>(current.x) + dx;
+                const int next_y = static_cast<int>(current.y) + dy;
+                if (next_x < 0 || next_y < 0) {
+                    continue;
+                }
+                const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
+                if (!map.is_walkable(next, true) || visited[next.y][next.x]) {
+                    continue;
+                }
+                visited[next.y][next.x] = true;
+                frontier.push(next);
+            }
+        }
+    }
+    const auto queue_end = std::chrono::steady_clock::now();
+
+    std::size_t bit_cells = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const auto word : map.reachable_from(map.entries(), Map::Plane::WalkableIgnoringTowers)) {
+            bit_cells += static_cast<std::size_t>(std::popcount(word));
+        }
+    }
+    const auto bit_end = std::chrono::steady_clock::now();
+
+    const double queue_us = std::chrono::duration<double, std::micro>(queue_end - queue_begin).count() / repetitions;
+    const double bit_us = std::chrono::duration<double, std::micro>(bit_end - queue_end).count() / repetitions;
+    std::cout << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+              << queue_us << std::setw(12) << bit_us << std::setw(9) << queue_us / bit_us << 'x'
+              << (queue_cells == bit_cells ? "" : "  (reached cell mismatch!)") << '\n';
+}
+
+// Routes from the resource and the entries to the nearest exit: one flat
+// search per exit keeping the shortest, against a single multi-goal search.
+void run_nearest_exit(const std::string& label, const Map& map, int repetitions) {
+    std::vector<GridPosition> starts = map.entries();
+    starts.push_back(map.resource_position());
+    const auto& exits = map.exits();
+
+    PathFinder finder{map, 0, PathFinder::Strategy::Flat};
+    std::size_t per_exit_length = 0;
+    const auto per_exit_begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (const auto& start : starts) {
+            std::optional<std::vector<GridPosition>> best;
+            for (const auto& exit : exits) {
+                auto path = finder.shortest_path(start, exit);
+                if (path && (!best || path->size() < best->size())) {
+                    best = std::move(path);
+                }
+            }
+            per_exit_length += best ? best->size() : 0;
+        }
+    }
+    const auto per_exit_end = std::chrono::steady_clock::now();
+
+    std::size_t any_length = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const auto& start : starts) {
+            if (auto path = finder.shortest_path_to_any(start, exits)) {
+                any_length += path->size();
+            }
+        }
+    }
+    const auto any_end = std::chrono::steady_clock::now();
+
+    const auto queries = static_cast<double>(starts.size() * repetitions);
+    const double per_exit_us = std::chrono::duration<double, std::micro>(per_exit_end - per_exit_begin).count() / queries;
+    const double any_us = std::chrono::duration<double, std::micro>(any_end - per_exit_end).count() / queries;
+    std::cout << std::left << std::setw(28) << label << std::right << std::setw(7) << exits.size() << std::fixed
+              << std::setprecision(1) << std::setw(12) << per_exit_us << std::setw(12) << any_us << std::setw(9)
+              << per_exit_us / any_us << 'x' << (per_exit_length == any_length ? "" : "  (path length mismatch!)")
+              << '\n';
+}
+
+// Alternates a tower placement with a random query, the pattern a large
+// editor map sees, and compares flat BFS, jump points and the hierarchy.
+void run_hierarchy(std::size_t size, int queries) {
+    std::cout << "\nhierarchical vs flat (" << size << 'x' << size << ", " << queries
+              << " queries, one tower placed before each)\n";
+    std::cout << std::setw(14) << "strategy" << std::setw(12) << "us/query" << std::setw(14) << "path cells" << '\n';
+    for (const auto strategy :
+        {PathFinder::Strategy::Flat, PathFinder::Strategy::JumpPoint, PathFinder::Strategy::Hierarchical}) {
+        Map map = Map::from_lines(open_field_lines(size));
+        PathFinder finder{map, PathCache::kDefaultMemoryBudget, strategy};
+        std::size_t state = 777;
+        auto next = [&state, size] {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<std::size_t>(state >> 33) % size;
+        };
+        std::size_t checksum = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            const GridPosition tower{next(), next()};
+            if (map.at(tower) == TileType::Path) {
+                map.set(tower, TileType::Tower);
+                finder.update_cell(tower);
+            }
+            const GridPosition start{next(), next()};
+            const GridPosition goal{next(), next()};
+            if (auto path = finder.shortest_path(start, goal)) {
+                checksum += path->size();
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const char* name = strategy == PathFinder::Strategy::Flat ? "flat"
+            : strategy == PathFinder::Strategy::JumpPoint         ? "jump point"
+                                                                  : "hierarchical";
+        std::cout << std::setw(14) << name << std::fixed
+                  << std::setprecision(1) << std::setw(12)
+                  << std::chrono::duration<double, std::micro>(end - begin).count() / queries << std::setw(14)
+                  << checksum << '\n';
+    }
+}
+
+// Tile reads under the two grid layouts: a whole-map walk in storage order,
+// a column-by-column walk, and square windows the size of a tower's reach.
+void run_layout(std::size_t size) {
+    std::cout << "\ngrid layout (" << size << 'x' << size << ")\n"
+              << std::setw(14) << "layout" << std::setw(12) << "scan ms" << std::setw(12) << "column ms"
+              << std::setw(12) << "window ms" << std::setw(12) << "checksum" << '\n';
+    constexpr std::size_t kWindows = 20000;
+    constexpr std::size_t kRadius = 8;
+    for (const auto layout : {Map::Layout::RowMajor, Map::Layout::Tiled}) {
+        Map map = Map::from_lines(rooms_lines(size));
+        map.set_layout(layout);
+        std::size_t checksum = 0;
+
+        const auto scan_begin = std::chrono::steady_clock::now();
+        map.for_each_cell([&](const GridPosition&, TileType tile) { checksum += tile == TileType::Path ? 1 : 0; });
+        const auto column_begin = std::chrono::steady_clock::now();
+        for (std::size_t x = 0; x < size; ++x) {
+            for (std::size_t y = 0; y < size; ++y) {
+                checksum += map.at(GridPosition{x, y}) == TileType::Path ? 1 : 0;
+            }
+        }
+        const auto window_begin = std::chrono::steady_clock::now();
+        std::size_t state = 4242;
+        for (std::size_t i = 0; i < kWindows; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const std::size_t cx = static_cast<std::size_t>(state >> 33) % (size - 2 * kRadius) + kRadius;
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const std::size_t cy = static_cast<std::size_t>(state >> 33) % (size - 2 * kRadius) + kRadius;
+            for (std::size_t y = cy - kRadius; y <= cy + kRadius; ++y) {
+                for (std::size_t x = cx - kRadius; x <= cx + kRadius; ++x) {
+                    checksum += map.at(GridPosition{x, y}) == TileType::Path ? 1 : 0;
+                }
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+        std::cout << std::setw(14) << (layout == Map::Layout::RowMajor ? "row-major" : "tiled 8x8") << std::fixed
+                  << std::setprecision(2) << std::setw(12) << ms(scan_begin, column_begin) << std::setw(12)
+                  << ms(column_begin, window_begin) << std::setw(12) << ms(window_begin, end) << std::setw(12)
+                  << checksum << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::filesystem::path maps_root = argc > 1 ? std::filesystem::path{argv[1]} : std::filesystem::path{"data"} / "maps";
+
+    std::cout << std::left << std::setw(28) << "map" << std::setw(14) << "size" << std::right << std::setw(12)
+              << "legacy us" << std::setw(12) << "flat us" << std::setw(12) << "jps us" << std::setw(10) << "flat x"
+              << std::setw(10) << "jps x" << '\n';
+
+    if (std::filesystem::exists(maps_root)) {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(maps_root)) {
+            if (entry.path().extension() == ".txt") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto& file : files) {
+            run_case(file.filename().string(), Map::load_from_file(file.string()), 20000);
+        }
+    } else {
+        std::cout << "Map directory not found: " << maps_root << '\n';
+    }
+
+    const Map serpentine = Map::from_lines(serpentine_lines(512));
+    run_case("generated serpentine", serpentine, 10);
+    run_case("generated open field", Map::from_lines(open_field_lines(512)), 10);
+    run_case("generated rooms", Map::from_lines(rooms_lines(512)), 10);
+    run_cache_sizing(serpentine);
+
+    std::cout << "\nreachability from entries (512x512)\n"
+              << std::left << std::setw(28) << "map" << std::right << std::setw(12) << "queue us" << std::setw(12)
+              << "bitset us" << std::setw(10) << "speedup" << '\n';
+    run_reachability("generated serpentine", serpentine, 20);
+    run_reachability("generated open field", Map::from_lines(open_field_lines(512)), 20);
+    run_reachability("generated rooms", Map::from_lines(rooms_lines(512)), 20);
+
+    std::cout << "\nnearest exit (512x512)\n"
+              << std::left << std::setw(28) << "map" << std::right << std::setw(7) << "exits" << std::setw(12)
+              << "per exit us" << std::setw(12) << "any us" << std::setw(10) << "speedup" << '\n';
+    run_nearest_exit("generated serpentine", Map::from_lines(with_exits(serpentine_lines(512))), 5);
+    run_nearest_exit("generated open field", Map::from_lines(with_exits(open_field_lines(512))), 5);
+    run_nearest_exit("generated rooms", Map::from_lines(with_exits(rooms_lines(512))), 5);
+    run_hierarchy(2048, 100);
+    run_layout(1024);
+    run_layout(4096);
+    return 0;
+}
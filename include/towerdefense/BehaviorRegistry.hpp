@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace towerdefense {
+
+// One bit per distinct creature behavior name.
+using BehaviorMask = std::uint64_t;
+
+// Process-wide interning of behavior names. Wave files keep naming
+// behaviors as strings; they are turned into bits once when loaded so the
+// per-tick checks are a single AND. Behaviors the engine reacts to have
+// fixed bits.
+class BehaviorRegistry {
+public:
+    static constexpr std::size_t kCapacity = 64;
+    static constexpr BehaviorMask kBurrower = BehaviorMask{1} << 0;
+    static constexpr BehaviorMask kDestroyer = BehaviorMask{1} << 1;
+
+    // Returns the bit for name, assigning the next free one on first use.
+    // Throws std::runtime_error once kCapacity names are in use.
+    static BehaviorMask intern(std::string_view name);
+    static BehaviorMask intern(const std::vector<std::string>& names);
+};
+
+} // namespace towerdefense
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "GridPosition.hpp"
+#include "Map.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace towerdefense {
+
+// Marks every cell whose blocking would cut all entry -> resource routes or
+// all resource -> exit routes. Built from articulation points of the walkable
+// grid, so a placement check is a single lookup until the map changes again.
+class ConnectivityIndex {
+public:
+    void rebuild(const Map& map);
+
+    [[nodiscard]] bool connected() const noexcept { return connected_; }
+    [[nodiscard]] bool would_disconnect(const GridPosition& pos) const noexcept;
+
+private:
+    std::size_t width_{};
+    std::size_t height_{};
+    bool connected_{false};
+    std::vector<std::uint8_t> critical_{};
+
+    // Scratch for the iterative depth-first search, kept between rebuilds.
+    std::vector<std::uint32_t> discovery_{};
+    std::vector<std::uint32_t> low_{};
+    std::vector<std::uint32_t> parent_{};
+    std::vector<std::uint8_t> next_edge_{};
+    std::vector<std::uint8_t> is_source_{};
+
+    bool mark_cuts(const Map& map, const std::vector<GridPosition>& sources);
+};
+
+} // namespace towerdefense
@@ -0,0 +1,22 @@
+#pragma once
+
+// Shared by the translation units that carry hand-vectorized kernels.
+// TOWERDEFENSE_X86_KERNELS is defined where AVX2 code can be compiled, and
+// functions using AVX2 intrinsics are marked TOWERDEFENSE_TARGET_AVX2 so the
+// rest of the build keeps the baseline instruction set.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define TOWERDEFENSE_X86_KERNELS 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TOWERDEFENSE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TOWERDEFENSE_TARGET_AVX2
+#endif
+#endif
+
+namespace towerdefense {
+
+// Whether this CPU and OS run AVX2 code, detected once.
+[[nodiscard]] bool cpu_has_avx2() noexcept;
+
+} // namespace towerdefense
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "BehaviorRegistry.hpp"
+#include "Materials.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace towerdefense {
+
+// Stats shared by every creature of one kind. Blueprints are immutable once
+// handed out; creatures keep a handle and only own their mutable state.
+struct CreatureBlueprint {
+    std::string id;
+    std::string name;
+    int max_health{};
+    double speed{};
+    Materials reward;
+    int armor{0};
+    int shield{0};
+    bool flying{false};
+    std::vector<std::string> behaviors;
+    BehaviorMask behavior_mask{0};
+};
+
+using BlueprintHandle = std::shared_ptr<const CreatureBlueprint>;
+
+} // namespace towerdefense
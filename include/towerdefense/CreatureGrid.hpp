@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CreatureStore.hpp"
+#include "GridPosition.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace towerdefense {
+
+class Map;
+
+// Live creatures bucketed by map area, so a tower's range query only visits
+// the few buckets it overlaps. Rebuilt once per tick before towers fire;
+// positions do not change while they do.
+class CreatureGrid {
+public:
+    // Bucket side length in cells, about one tower range across.
+    static constexpr std::size_t kBucketSize = 4;
+
+    CreatureGrid() = default;
+    CreatureGrid(std::size_t width, std::size_t height);
+
+    // Buckets every alive creature that has not exited, both by area and by
+    // cell. Creatures on a cell the map does not let them walk, even past
+    // towers, are also listed as strays.
+    void rebuild(const CreatureStore& creatures, const Map& map);
+
+    // Replaces out with the creatures still alive within radius of origin,
+    // bucket by bucket. Target selection breaks ties by spawn sequence, so
+    // the order does not matter to it.
+    void query(const CreatureStore& creatures, const GridPosition& origin, double radius,
+        std::vector<std::size_t>& out) const;
+
+    // Creatures standing on cell, by ascending index. Some may have died
+    // since the rebuild.
+    // cell must lie on the map the grid was sized for.
+    [[nodiscard]] std::span<const std::uint32_t> occupants(CellId cell) const noexcept {
+        return {cell_entries_.data() + cell_starts_[cell], cell_entries_.data() + cell_starts_[cell + 1]};
+    }
+    // Usually empty: creatures squeezed onto a tile that has since stopped
+    // being walkable, e.g. a destroyed tower's.
+    [[nodiscard]] std::span<const std::uint32_t> strays() const noexcept { return strays_; }
+
+private:
+    std::size_t width_{0};
+    std::size_t height_{0};
+    std::size_t buckets_x_{0};
+    std::size_t buckets_y_{0};
+    // Bucket b holds entries_[starts_[b], starts_[b + 1]), by ascending index.
+    std::vector<std::uint32_t> starts_{};
+    std::vector<std::uint32_t> entries_{};
+    // Bucket of each creature slot, refilled by every rebuild; only the
+    // allocation carries over.
+    std::vector<std::uint32_t> bucket_of_{};
+    // The same layout per cell.
+    std::vector<std::uint32_t> cell_starts_{};
+    std::vector<std::uint32_t> cell_entries_{};
+    std::vector<CellId> cell_of_{};
+    std::vector<std::uint32_t> strays_{};
+
+    [[nodiscard]] std::size_t bucket_column(std::size_t x) const noexcept;
+    [[nodiscard]] std::size_t bucket_row(std::size_t y) const noexcept;
+};
+
+} // namespace towerdefense
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "Creature.hpp"
+#include "GridPosition.hpp"
+#include "Materials.hpp"
+#include "Route.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace towerdefense {
+
+// Names one creature across ticks. A handle goes stale when its creature
+// is removed; a later creature reusing the slot gets a new generation.
+struct CreatureHandle {
+    std::uint32_t index{0};
+    std::uint32_t generation{0};
+
+    [[nodiscard]] bool operator==(const CreatureHandle& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+    [[nodiscard]] bool operator!=(const CreatureHandle& other) const noexcept { return !(*this == other); }
+};
+
+// Live creatures stored as parallel arrays. Fields read every tick by
+// movement and tower scans sit in their own arrays; names, rewards, armor
+// and behavior lists are read through the shared blueprint.
+//
+// Creatures keep their slot index for as long as they are stored; removed
+// slots go on a free list and are reused by later pushes, so slot order is
+// not spawn order. spawn_sequence() keeps the latter for tie-breaking.
+// Index loops run to slot_count() and skip vacant slots, which never report
+// alive.
+class CreatureStore {
+public:
+    class ConstRef;
+    class Iterator;
+
+    // Stored creatures, including dead ones not yet removed.
+    [[nodiscard]] std::size_t size() const noexcept { return slot_count() - free_slots_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] std::size_t slot_count() const noexcept { return health_.size(); }
+    // Creatures still alive and on the map, kept up to date by damage.
+    [[nodiscard]] std::size_t alive_count() const noexcept { return alive_count_; }
+
+    // Takes over the creature's current state, reusing a free slot if any.
+    CreatureHandle push(Creature creature);
+    void clear() noexcept;
+
+    [[nodiscard]] bool is_occupied(std::size_t index) const noexcept { return (flags_[index] & kVacant) == 0; }
+    [[nodiscard]] CreatureHandle handle(std::size_t index) const noexcept {
+        return CreatureHandle{static_cast<std::uint32_t>(index), generations_[index]};
+    }
+    // Slot index of the creature, or nullopt once it has been removed.
+    [[nodiscard]] std::optional<std::size_t> find(CreatureHandle handle) const noexcept {
+        if (handle.index >= slot_count() || generations_[handle.index] != handle.generation || !is_occupied(handle.index)) {
+            return std::nullopt;
+        }
+        return handle.index;
+    }
+
+    // Increases with every push; older creatures have smaller values.
+    [[nodiscard]] std::uint64_t spawn_sequence(std::size_t index) const noexcept { return spawn_sequences_[index]; }
+    [[nodiscard]] const GridPosition& position(std::size_t index) const noexcept { return positions_[index]; }
+    [[nodiscard]] int health(std::size_t index) const noexcept { return health_[index]; }
+    [[nodiscard]] int shield(std::size_t index) const noexcept { return shield_[index]; }
+    [[nodiscard]] int armor(std::size_t index) const noexcept { return blueprints_[index]->armor; }
+    [[nodiscard]] double speed(std::size_t index) const noexcept { return speed_[index]; }
+    [[nodiscard]] bool is_alive(std::size_t index) const noexcept { return health_[index] > 0; }
+    [[nodiscard]] bool is_flying(std::size_t index) const noexcept { return (flags_[index] & kFlying) != 0; }
+    [[nodiscard]] bool reached_goal(std::size_t index) const noexcept { return (flags_[index] & kReachedGoal) != 0; }
+    [[nodiscard]] bool is_carrying_resource(std::size_t index) const noexcept { return (flags_[index] & kCarrying) != 0; }
+    [[nodiscard]] bool has_exited(std::size_t index) const noexcept { return (flags_[index] & kExited) != 0; }
+    [[nodiscard]] bool has_behavior(std::size_t index, BehaviorMask behavior) const noexcept {
+        return (behaviors_[index] & behavior) != 0;
+    }
+    [[nodiscard]] const RouteHandle& route(std::size_t index) const noexcept { return routes_[index]; }
+    [[nodiscard]] int current_segment(std::size_t index) const noexcept { return static_cast<int>(segments_[index]); }
+    [[nodiscard]] std::pair<double, double> interpolated_position(std::size_t index) const noexcept;
+
+    [[nodiscard]] const CreatureBlueprint& blueprint(std::size_t index) const noexcept { return *blueprints_[index]; }
+    [[nodiscard]] const std::string& id(std::size_t index) const noexcept { return blueprints_[index]->id; }
+    [[nodiscard]] const std::string& name(std::size_t index) const noexcept { return blueprints_[index]->name; }
+    [[nodiscard]] int max_health(std::size_t index) const noexcept { return max_health_[index]; }
+    [[nodiscard]] const Materials& reward(std::size_t index) const noexcept { return blueprints_[index]->reward; }
+    [[nodiscard]] const Materials& steal_amount(std::size_t index) const noexcept { return blueprints_[index]->reward; }
+    [[nodiscard]] int leak_damage(std::size_t) const noexcept { return 1; }
+    [[nodiscard]] const std::vector<std::string>& behaviors(std::size_t index) const noexcept {
+        return blueprints_[index]->behaviors;
+    }
+
+    void assign_path(std::size_t index, RouteHandle route);
+    void start_returning(std::size_t index, RouteHandle route);
+    void apply_damage(std::size_t index, int amount);
+    void apply_slow(std::size_t index, double factor, int duration);
+    void mark_goal_reached(std::size_t index) noexcept { flags_[index] |= kReachedGoal | kCarrying; }
+
+    // Moves every living creature along its route for one tick.
+    void advance_all() noexcept;
+
+    // Frees the slot of every dead creature; survivors stay where they are.
+    // on_remove(index) runs for each dead creature before its slot is freed.
+    template <typename OnRemove>
+    void remove_dead(OnRemove&& on_remove) {
+        for (std::size_t i = 0; i < slot_count(); ++i) {
+            if (is_occupied(i) && !is_alive(i)) {
+                on_remove(i);
+                release(i);
+            }
+        }
+    }
+
+    [[nodiscard]] ConstRef operator[](std::size_t index) const noexcept;
+    [[nodiscard]] Iterator begin() const noexcept;
+    [[nodiscard]] Iterator end() const noexcept;
+
+private:
+    static constexpr std::uint8_t kFlying = 1U << 0;
+    static constexpr std::uint8_t kReachedGoal = 1U << 1;
+    static constexpr std::uint8_t kCarrying = 1U << 2;
+    static constexpr std::uint8_t kExited = 1U << 3;
+    static constexpr std::uint8_t kVacant = 1U << 4;
+    // Has a route to follow; movement skips creatures without one.
+    static constexpr std::uint8_t kRouted = 1U << 5;
+
+    // Hot: read by movement, targeting and damage every tick.
+    std::vector<GridPosition> positions_{};
+    std::vector<int> health_{};
+    std::vector<int> shield_{};
+    std::vector<double> speed_{};
+    std::vector<double> progress_{};
+    std::vector<double> slow_factor_{};
+    std::vector<int> slow_duration_{};
+    std::vector<std::uint32_t> segments_{};
+    std::vector<RouteHandle> routes_{};
+    std::vector<std::uint8_t> flags_{};
+    std::vector<BehaviorMask> behaviors_{};
+    // Cold: per-instance maximum health and the shared blueprint.
+    std::vector<int> max_health_{};
+    std::vector<BlueprintHandle> blueprints_{};
+    std::vector<std::uint64_t> spawn_sequences_{};
+    std::vector<std::uint32_t> generations_{};
+    std::vector<std::uint32_t> free_slots_{};
+    std::uint64_t next_spawn_sequence_{0};
+    std::size_t alive_count_{0};
+    // Scratch for advance_all(): creatures due to enter their next cell.
+    std::vector<std::uint32_t> steps_{};
+
+    void release(std::size_t index) noexcept;
+};
+
+// Read-only view of one stored creature, mirroring Creature's accessors.
+class CreatureStore::ConstRef {
+public:
+    ConstRef(const CreatureStore& store, std::size_t index) noexcept
+        : store_(&store)
+        , index_(index) {}
+
+    [[nodiscard]] std::size_t index() const noexcept { return index_; }
+    [[nodiscard]] CreatureHandle handle() const noexcept { return store_->handle(index_); }
+    [[nodiscard]] const GridPosition& position() const noexcept { return store_->position(index_); }
+    [[nodiscard]] int health() const noexcept { return store_->health(index_); }
+    [[nodiscard]] int max_health() const noexcept { return store_->max_health(index_); }
+    [[nodiscard]] int shield() const noexcept { return store_->shield(index_); }
+    [[nodiscard]] int armor() const noexcept { return store_->armor(index_); }
+    [[nodiscard]] double speed() const noexcept { return store_->speed(index_); }
+    [[nodiscard]] bool is_alive() const noexcept { return store_->is_alive(index_); }
+    [[nodiscard]] bool is_flying() const noexcept { return store_->is_flying(index_); }
+    [[nodiscard]] bool reached_goal() const noexcept { return store_->reached_goal(index_); }
+    [[nodiscard]] bool is_carrying_resource() const noexcept { return store_->is_carrying_resource(index_); }
+    [[nodiscard]] bool has_exited() const noexcept { return store_->has_exited(index_); }
+    [[nodiscard]] bool has_behavior(BehaviorMask behavior) const noexcept { return store_->has_behavior(index_, behavior); }
+    [[nodiscard]] const RouteHandle& route() const noexcept { return store_->route(index_); }
+    [[nodiscard]] int current_segment() const noexcept { return store_->current_segment(index_); }
+    [[nodiscard]] std::pair<double, double> interpolated_position() const noexcept {
+        return store_->interpolated_position(index_);
+    }
+    [[nodiscard]] const std::string& id() const noexcept { return store_->id(index_); }
+    [[nodiscard]] const std::string& name() const noexcept { return store_->name(index_); }
+    [[nodiscard]] const Materials& reward() const noexcept { return store_->reward(index_); }
+    [[nodiscard]] const std::vector<std::string>& behaviors() const noexcept { return store_->behaviors(index_); }
+
+private:
+    const CreatureStore* store_;
+    std::size_t index_;
+};
+
+class CreatureStore::Iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ConstRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = ConstRef;
+
+    Iterator() = default;
+    Iterator(const CreatureStore& store, std::size_t index) noexcept
+        : store_(&store)
+        , index_(index) {
+        skip_vacant();
+    }
+
+    [[nodiscard]] ConstRef operator*() const noexcept { return ConstRef{*store_, index_}; }
+    Iterator& operator++() noexcept {
+        ++index_;
+        skip_vacant();
+        return *this;
+    }
+    Iterator operator++(int) noexcept {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+    [[nodiscard]] bool operator==(const Iterator& other) const noexcept { return index_ == other.index_; }
+    [[nodiscard]] bool operator!=(const Iterator& other) const noexcept { return index_ != other.index_; }
+
+private:
+    const CreatureStore* store_{nullptr};
+    std::size_t index_{0};
+
+    void skip_vacant() noexcept {
+        while (index_ < store_->slot_count() && !store_->is_occupied(index_)) {
+            ++index_;
+        }
+    }
+};
+
+inline CreatureStore::ConstRef CreatureStore::operator[](std::size_t index) const noexcept {
+    return ConstRef{*this, index};
+}
+
+inline CreatureStore::Iterator CreatureStore::begin() const noexcept {
+    return Iterator{*this, 0};
+}
+
+inline CreatureStore::Iterator CreatureStore::end() const noexcept {
+    return Iterator{*this, slot_count()};
+}
+
+} // namespace towerdefense
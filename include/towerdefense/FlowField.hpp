@@ -0,0 +1,92 @@
+#pragma once
+
+#include "GridPosition.hpp"
+#include "Map.hpp"
+#include "Route.hpp"
+#include "WorkerPool.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace towerdefense {
+
+// Reverse-BFS distance fields towards the resource and towards the nearest
+// exit. A field is built once and shared by every creature heading to that
+// goal, so routing a creature only walks downhill from its cell. Routes are
+// pooled per start cell until the field changes, so creatures spawned from
+// the same entry share one route.
+class FlowField {
+public:
+    struct RouteRequest {
+        GridPosition start{};
+        bool to_nearest_exit{false};
+        bool allow_tower_squeeze{false};
+    };
+
+    static constexpr std::uint32_t kUnreachable = 0xFFFFFFFFu;
+
+    explicit FlowField(const Map& map);
+
+    // Both return nullptr when no route exists.
+    [[nodiscard]] RouteHandle route_to_resource(const GridPosition& start, bool allow_tower_squeeze = false);
+    [[nodiscard]] RouteHandle route_to_nearest_exit(const GridPosition& start, bool allow_tower_squeeze = false);
+    // Answers results[i] for requests[i]. Fields are built up front, then the
+    // distinct start cells are traced on the pool's workers against the
+    // unchanging map and pooled in request order, so the outcome does not
+    // depend on scheduling.
+    void route_batch(std::span<const RouteRequest> requests, std::span<RouteHandle> results, WorkerPool& workers);
+
+    // Tower-respecting step counts per cell, row-major, built on demand.
+    [[nodiscard]] const std::vector<std::uint32_t>& resource_distances();
+    [[nodiscard]] const std::vector<std::uint32_t>& exit_distances();
+    // Adopts fields computed earlier for this exact map, e.g. from a map
+    // bundle, so the first route needs no search.
+    void preload(std::span<const std::uint32_t> to_resource, std::span<const std::uint32_t> to_exit);
+
+    // Repairs every built field after the walkability of a single cell
+    // changed. Only the region whose distances actually moved is revisited.
+    void update_cell(const GridPosition& position);
+    void invalidate();
+
+private:
+    using Path = std::vector<GridPosition>;
+
+    struct Field {
+        std::vector<std::uint32_t> distance{};
+        std::unordered_map<CellId, RouteHandle> routes{};
+        bool valid{false};
+    };
+
+    enum class Goal : std::size_t {
+        Resource = 0,
+        NearestExit = 1,
+    };
+
+    const Map* map_{nullptr};
+    // Two layers per goal: [goal * 2] respects towers, [goal * 2 + 1] lets
+    // burrowers and destroyers squeeze through them.
+    std::array<Field, 4> fields_{};
+    // One trace buffer per worker for route_batch.
+    std::vector<Path> trace_scratch_{};
+
+    [[nodiscard]] Field& field(Goal goal, bool ignore_towers);
+    // Builds the layers a request may need and returns the slot that reaches
+    // start, or nullopt when neither does.
+    [[nodiscard]] std::optional<std::size_t> reaching_slot(Goal goal, const GridPosition& start, bool allow_tower_squeeze);
+    [[nodiscard]] RouteHandle route_to_goal(Goal goal, const GridPosition& start, bool allow_tower_squeeze);
+    [[nodiscard]] bool is_goal_cell(Goal goal, const GridPosition& position) const;
+    void build(Field& field, Goal goal, bool ignore_towers) const;
+    void repair_blocked(Field& field, CellId cell, bool ignore_towers) const;
+    void repair_opened(Field& field, CellId cell, bool ignore_towers) const;
+    void propagate(Field& field, std::vector<CellId>& frontier, bool ignore_towers) const;
+    template <typename Visitor>
+    void for_each_neighbor(CellId cell, Visitor&& visit) const;
+    void trace(const Field& field, const GridPosition& start, Path& path) const;
+    [[nodiscard]] RouteHandle follow(Field& field, const GridPosition& start) const;
+};
+
+} // namespace towerdefense
@@ -1,14 +1,21 @@
 #pragma once
 
+#include "ConnectivityIndex.hpp"
 #include "Creature.hpp"
+#include "CreatureGrid.hpp"
+#include "CreatureStore.hpp"
+#include "FlowField.hpp"
 #include "Map.hpp"
 #include "Materials.hpp"
 #include "PathFinder.hpp"
 #include "ResourceManager.hpp"
 #include "Tower.hpp"
 #include "TowerFactory.hpp"
+#include "TowerStore.hpp"
 #include "Wave.hpp"
+#include "WorkerPool.hpp"
 
+#include <cstdint>
 #include <deque>
 #include <optional>
 #include <unordered_map>
@@ -44,21 +51,17 @@ public:
         if (resource_units_ <= 0) {
             return true;
         }
-        if (!pending_waves_.empty()) {
-            return false;
-        }
-        for (const auto& creature : creatures_) {
-            if (creature.is_alive() && !creature.has_exited()) {
-                return false;
-            }
-        }
-        return true;
+        return pending_waves_.empty() && creatures_.alive_count() == 0;
     }
-    [[nodiscard]] const std::vector<TowerPtr>& towers() const noexcept { return towers_; }
-    [[nodiscard]] const std::vector<Creature>& creatures() const noexcept { return creatures_; }
+    [[nodiscard]] const TowerStore& towers() const noexcept { return towers_; }
+    [[nodiscard]] const CreatureStore& creatures() const noexcept { return creatures_; }
     [[nodiscard]] bool has_pending_waves() const noexcept { return !pending_waves_.empty(); }
     [[nodiscard]] Tower* tower_at(const GridPosition& position);
     [[nodiscard]] const Tower* tower_at(const GridPosition& position) const;
+    [[nodiscard]] std::optional<TowerHandle> tower_handle(const GridPosition& position) const;
+    // nullptr once the tower has been sold or destroyed.
+    [[nodiscard]] Tower* tower(TowerHandle handle) noexcept { return towers_.find(handle); }
+    [[nodiscard]] const Tower* tower(TowerHandle handle) const noexcept { return towers_.find(handle); }
     [[nodiscard]] bool can_place_tower(
         const std::string& type, const GridPosition& position, std::string* reason = nullptr) const;
     [[nodiscard]] std::size_t map_version() const noexcept { return map_version_; }
@@ -77,12 +80,28 @@ private:
     ResourceManager resource_manager_;
     int resource_units_{};
     int max_resource_units_{};
-    std::vector<TowerPtr> towers_{};
-    std::vector<Creature> creatures_{};
-    std::unordered_map<GridPosition, TileType, GridPositionHash> tile_restore_;
+    TowerStore towers_{};
+    CreatureStore creatures_{};
+    // Rebuilt at the start of towers_attack().
+    CreatureGrid creature_grid_{};
+    // Per-cell side tables kept in step with towers_ by place, sell and
+    // destroy: the slot of the tower's handle (kNoTower when empty) and the
+    // tile the tower was built on.
+    static constexpr std::uint32_t kNoTower = 0xFFFFFFFFu;
+    std::vector<std::uint32_t> tower_slots_{};
+    std::vector<TileType> original_tiles_{};
     std::deque<PendingWaveEntry> pending_waves_{};
     GameOptions options_{};
-    PathFinder path_finder_;
+    FlowField flow_field_;
+    // Serves current_entry_path; large maps keep a cluster hierarchy that
+    // is patched per placed or removed tower.
+    mutable PathFinder path_finder_;
+    mutable ConnectivityIndex connectivity_;
+    mutable std::optional<std::size_t> connectivity_version_{};
+    WorkerPool path_workers_{};
+    std::vector<FlowField::RouteRequest> route_requests_{};
+    std::vector<RouteHandle> route_results_{};
+    std::vector<std::size_t> route_owners_{};
     std::size_t wave_index_{};
     std::size_t entry_spawn_index_{};
     bool breach_since_last_income_{false};
@@ -99,17 +118,16 @@ private:
     void spawn_ambient_creatures();
     void move_creatures();
     void towers_attack();
+    // Brings every tower's coverage up to the current map version.
+    void refresh_tower_coverage();
     void cleanup_creatures();
     void recalculate_creature_paths();
-    void handle_goal(Creature& creature);
+    void handle_goal(std::size_t creature);
     bool would_block_paths(const GridPosition& position) const;
-    bool path_exists_via_entries(const Map& map) const;
     Tower* find_tower(const GridPosition& position);
-    [[nodiscard]] std::optional<std::vector<GridPosition>> compute_path(const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze = false);
-    [[nodiscard]] std::optional<std::vector<GridPosition>> best_exit_path(const GridPosition& from, bool allow_tower_squeeze = false);
-    [[nodiscard]] bool creature_has_behavior(const Creature& creature, std::string_view behavior) const;
+    [[nodiscard]] RouteHandle resource_path(const GridPosition& from, bool allow_tower_squeeze = false);
     void destroy_tower(const GridPosition& position, const std::string& source);
-    [[nodiscard]] std::optional<std::size_t> tower_index(const GridPosition& position) const;
+    void remove_tower(TowerHandle handle, const GridPosition& position);
 };
 
 } // namespace towerdefense
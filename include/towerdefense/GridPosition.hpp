@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <string>
 
 namespace towerdefense {
@@ -21,9 +23,28 @@ struct GridPosition {
     [[nodiscard]] std::string to_string() const;
 };
 
+// Row-major cell index (y * width + x). Engine internals key tables and
+// buffers by CellId; GridPosition stays the public coordinate type.
+using CellId = std::uint32_t;
+
+inline constexpr CellId kInvalidCell = std::numeric_limits<CellId>::max();
+
+[[nodiscard]] constexpr CellId to_cell_id(const GridPosition& pos, std::size_t width) noexcept {
+    return static_cast<CellId>(pos.y * width + pos.x);
+}
+
+[[nodiscard]] constexpr GridPosition to_grid_position(CellId cell, std::size_t width) noexcept {
+    return GridPosition{cell % width, cell / width};
+}
+
 struct GridPositionHash {
     std::size_t operator()(const GridPosition& pos) const noexcept {
-        return std::hash<std::size_t>{}(pos.x) ^ (std::hash<std::size_t>{}(pos.y) << 1);
+        // Pack both coordinates and run the splitmix64 finalizer so nearby
+        // cells spread across buckets instead of colliding.
+        std::uint64_t key = (static_cast<std::uint64_t>(pos.y) << 32) ^ static_cast<std::uint64_t>(pos.x);
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<std::size_t>(key ^ (key >> 31));
     }
 };
 
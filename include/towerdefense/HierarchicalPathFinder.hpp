@@ -0,0 +1,88 @@
+#pragma once
+
+#include "GridPosition.hpp"
+#include "Map.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace towerdefense {
+
+// HPA* over square clusters of the map. Each cluster keeps the transition
+// cells on its borders and the in-cluster step counts between them; a query
+// searches that abstract graph and only then expands the chosen hops into
+// cells. Paths are near-shortest rather than exact, but a route is found
+// whenever one exists. A changed cell only dirties the clusters whose data
+// depend on it, and dirty clusters are rebuilt on the next query.
+class HierarchicalPathFinder {
+public:
+    static constexpr std::size_t kDefaultClusterSize = 32;
+
+    explicit HierarchicalPathFinder(const Map& map, std::size_t cluster_size = kDefaultClusterSize);
+
+    [[nodiscard]] std::optional<std::vector<GridPosition>> find_path(
+        const GridPosition& start, const GridPosition& goal, bool ignore_towers);
+
+    void update_cell(const GridPosition& position);
+    void invalidate();
+
+private:
+    using Path = std::vector<GridPosition>;
+
+    static constexpr std::uint32_t kUnreachable = 0xFFFFFFFFu;
+
+    struct Cluster {
+        // Transition cells, sorted by cell index.
+        std::vector<std::uint32_t> nodes{};
+        // nodes.size() x nodes.size() in-cluster distances.
+        std::vector<std::uint32_t> distance{};
+        bool dirty{true};
+    };
+
+    struct Layer {
+        std::vector<Cluster> clusters{};
+        bool built{false};
+    };
+
+    struct Bounds {
+        std::size_t x0{};
+        std::size_t y0{};
+        std::size_t width{};
+        std::size_t height{};
+    };
+
+    struct SearchEntry {
+        std::uint32_t cost{};
+        std::uint32_t parent{};
+        bool closed{false};
+    };
+
+    const Map* map_{nullptr};
+    std::size_t cluster_size_{};
+    std::size_t clusters_x_{};
+    std::size_t clusters_y_{};
+    // [0] respects towers, [1] treats them as walkable.
+    std::array<Layer, 2> layers_{};
+
+    // In-cluster search buffers, indexed by cell offset within the cluster.
+    std::vector<std::uint32_t> local_distance_{};
+    std::vector<std::uint32_t> local_parent_{};
+    std::vector<std::uint32_t> local_frontier_{};
+    std::unordered_map<std::uint32_t, SearchEntry> search_{};
+
+    [[nodiscard]] std::size_t cluster_of(std::uint32_t cell) const noexcept;
+    [[nodiscard]] Bounds bounds(std::size_t cluster) const noexcept;
+    [[nodiscard]] bool walkable(std::size_t x, std::size_t y, bool ignore_towers) const noexcept;
+    void mark_dirty(std::size_t cluster_x, std::size_t cluster_y);
+    void refresh(Layer& layer, bool ignore_towers);
+    void rebuild_cluster(Cluster& cluster, std::size_t index, bool ignore_towers);
+    void add_border_transitions(std::vector<std::uint32_t>& nodes, std::size_t index, bool ignore_towers) const;
+    void search_cluster(std::size_t cluster, std::uint32_t source, bool ignore_towers);
+    [[nodiscard]] std::uint32_t local_index(std::size_t cluster, std::uint32_t cell) const noexcept;
+    void append_segment(Path& path, std::uint32_t from, std::uint32_t to, bool ignore_towers);
+};
+
+} // namespace towerdefense
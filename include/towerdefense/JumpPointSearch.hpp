@@ -0,0 +1,47 @@
+#pragma once
+
+#include "GridPosition.hpp"
+#include "Map.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace towerdefense {
+
+// Jump point search for 4-connected grids. Straight runs are skipped 64
+// cells at a time over the map's walkability planes, and only cells where a
+// shortest path may have to turn enter the open list. Returned paths are as
+// short as a breadth-first search's, though they may take a different turn
+// among equally short alternatives.
+class JumpPointSearch {
+public:
+    explicit JumpPointSearch(const Map& map);
+
+    [[nodiscard]] std::optional<std::vector<GridPosition>> find_path(
+        const GridPosition& start, const GridPosition& goal, bool ignore_towers);
+
+private:
+    using Path = std::vector<GridPosition>;
+    using Plane = std::span<const std::uint64_t>;
+
+    struct Scratch {
+        std::vector<std::uint32_t> generation{};
+        std::vector<std::uint32_t> cost{};
+        std::vector<std::uint32_t> parent{};
+        std::uint32_t current{0};
+    };
+
+    const Map* map_{nullptr};
+    Scratch scratch_{};
+
+    [[nodiscard]] bool is_open(const Plane& plane, std::size_t x, std::size_t y) const noexcept;
+    [[nodiscard]] std::optional<std::size_t> jump_horizontal(
+        const Plane& plane, std::size_t x, std::size_t y, int dx, const GridPosition& goal) const noexcept;
+    [[nodiscard]] std::optional<std::size_t> jump_vertical(
+        const Plane& plane, std::size_t x, std::size_t y, int dy, const GridPosition& goal) const noexcept;
+    void prepare_scratch();
+};
+
+} // namespace towerdefense
@@ -3,7 +3,12 @@
 #include "GridPosition.hpp"
 #include "TileType.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -15,8 +20,34 @@ class Map {
 public:
     using Grid = std::vector<TileType>;
 
+    // Packed one-bit-per-cell views of the grid, kept in sync by set(). Rows
+    // start on a word boundary and padding bits past the width are clear.
+    enum class Plane : std::size_t {
+        Walkable = 0,
+        WalkableIgnoringTowers = 1,
+        Buildable = 2,
+    };
+
+    // Step counts to the resource and to the nearest exit, row-major, as
+    // stored in a map bundle. Dropped as soon as the map is modified.
+    struct DistanceFields {
+        std::vector<std::uint32_t> to_resource{};
+        std::vector<std::uint32_t> to_exit{};
+    };
+
+    // Storage order of the tile grid. Tiled keeps 8x8 blocks contiguous so
+    // cells that are close vertically are also close in memory. The bit
+    // planes are row-major in either layout.
+    enum class Layout {
+        RowMajor,
+        Tiled,
+    };
+
+    static constexpr std::size_t kTileSize = 8;
+
     Map() = default;
-    Map(std::size_t width, std::size_t height, Grid grid);
+    // The grid is always given row-major and stored in the requested layout.
+    Map(std::size_t width, std::size_t height, Grid grid, Layout layout = Layout::RowMajor);
 
     static Map load_from_file(const std::string& path);
     static Map from_lines(const std::vector<std::string>& lines);
@@ -24,31 +55,107 @@ public:
 
     [[nodiscard]] std::size_t width() const noexcept { return width_; }
     [[nodiscard]] std::size_t height() const noexcept { return height_; }
+    [[nodiscard]] std::size_t cell_count() const noexcept { return width_ * height_; }
+    [[nodiscard]] CellId cell_id(const GridPosition& pos) const noexcept { return to_cell_id(pos, width_); }
+    [[nodiscard]] GridPosition position_of(CellId cell) const noexcept { return to_grid_position(cell, width_); }
 
     [[nodiscard]] TileType at(const GridPosition& pos) const;
     void set(const GridPosition& pos, TileType type);
 
+    [[nodiscard]] Layout layout() const noexcept { return layout_; }
+    void set_layout(Layout layout);
+
+    // Calls visit(position, tile) for every cell in storage order. Prefer
+    // this over nested x/y loops for whole-map scans.
+    template <typename Visitor>
+    void for_each_cell(Visitor&& visit) const {
+        if (layout_ == Layout::RowMajor) {
+            const TileType* tile = grid_.data();
+            for (std::size_t y = 0; y < height_; ++y) {
+                for (std::size_t x = 0; x < width_; ++x) {
+                    visit(GridPosition{x, y}, *tile++);
+                }
+            }
+            return;
+        }
+        const TileType* block = grid_.data();
+        for (std::size_t by = 0; by < height_; by += kTileSize) {
+            const std::size_t rows = std::min(kTileSize, height_ - by);
+            for (std::size_t bx = 0; bx < width_; bx += kTileSize) {
+                const std::size_t columns = std::min(kTileSize, width_ - bx);
+                for (std::size_t dy = 0; dy < rows; ++dy) {
+                    const TileType* tile = block + dy * kTileSize;
+                    for (std::size_t dx = 0; dx < columns; ++dx) {
+                        visit(GridPosition{bx + dx, by + dy}, tile[dx]);
+                    }
+                }
+                block += kTileSize * kTileSize;
+            }
+        }
+    }
+
     [[nodiscard]] bool is_within_bounds(const GridPosition& pos) const noexcept;
     [[nodiscard]] bool is_walkable(const GridPosition& pos, bool treat_towers_as_walkable = false) const noexcept;
+    [[nodiscard]] bool is_buildable(const GridPosition& pos) const noexcept;
+
+    [[nodiscard]] std::size_t words_per_row() const noexcept { return words_per_row_; }
+    [[nodiscard]] std::span<const std::uint64_t> plane(Plane plane) const noexcept {
+        return planes_[static_cast<std::size_t>(plane)];
+    }
+    // Cells connected to any source through the plane, in plane layout.
+    // Sources count as reached even when the plane excludes them. Whole
+    // 64-cell words are filled per step.
+    [[nodiscard]] std::vector<std::uint64_t> reachable_from(std::span<const GridPosition> sources, Plane plane) const;
 
     [[nodiscard]] const std::vector<GridPosition>& entries() const noexcept { return entries_; }
     [[nodiscard]] const std::vector<GridPosition>& exits() const noexcept { return exits_; }
     [[nodiscard]] const GridPosition& resource_position() const;
 
-    void set_entries(std::vector<GridPosition> entries) { entries_ = std::move(entries); }
-    void set_exits(std::vector<GridPosition> exits) { exits_ = std::move(exits); }
-    void set_resource(std::optional<GridPosition> resource) { resource_ = resource; }
+    void set_entries(std::vector<GridPosition> entries) {
+        entries_ = std::move(entries);
+        distance_fields_.reset();
+    }
+    void set_exits(std::vector<GridPosition> exits) {
+        exits_ = std::move(exits);
+        distance_fields_.reset();
+    }
+    void set_resource(std::optional<GridPosition> resource) {
+        resource_ = resource;
+        distance_fields_.reset();
+    }
+
+    [[nodiscard]] const DistanceFields* distance_fields() const noexcept { return distance_fields_.get(); }
+    void set_distance_fields(std::shared_ptr<const DistanceFields> fields) { distance_fields_ = std::move(fields); }
 
+    [[nodiscard]] std::vector<std::string> render_with_entities(
+        const std::unordered_map<CellId, char>& entity_symbols) const;
     [[nodiscard]] std::vector<std::string> render_with_entities(
         const std::unordered_map<GridPosition, char, GridPositionHash>& entity_symbols) const;
 
 private:
     std::size_t width_{};
     std::size_t height_{};
+    Layout layout_{Layout::RowMajor};
+    std::size_t tiles_per_row_{};
     Grid grid_{};
+    std::size_t words_per_row_{};
+    std::array<std::vector<std::uint64_t>, 3> planes_{};
     std::optional<GridPosition> resource_{};
     std::vector<GridPosition> entries_{};
     std::vector<GridPosition> exits_{};
+    std::shared_ptr<const DistanceFields> distance_fields_{};
+
+    [[nodiscard]] std::size_t storage_index(std::size_t x, std::size_t y) const noexcept {
+        if (layout_ == Layout::RowMajor) {
+            return y * width_ + x;
+        }
+        const std::size_t tile = (y / kTileSize) * tiles_per_row_ + x / kTileSize;
+        return tile * kTileSize * kTileSize + (y % kTileSize) * kTileSize + x % kTileSize;
+    }
+    [[nodiscard]] bool test(Plane plane, const GridPosition& pos) const noexcept {
+        return (planes_[static_cast<std::size_t>(plane)][pos.y * words_per_row_ + pos.x / 64] >> (pos.x % 64)) & 1U;
+    }
+    void update_planes(const GridPosition& pos, TileType type) noexcept;
 };
 
 } // namespace towerdefense
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Map.hpp"
+
+#include <filesystem>
+#include <string_view>
+
+namespace towerdefense {
+
+// Binary level format. A bundle holds a fully prepared map (crystal already
+// relocated, unused paths already pruned) together with its distance fields
+// to the resource and to the nearest exit. Loading maps the file and copies
+// the sections out without parsing or searching.
+//
+// Layout, native little-endian, every section 8-byte aligned:
+//   header | tiles (u8 per cell) | entries (u32 x, y) | exits (u32 x, y)
+//   | distance to resource (u32 per cell) | distance to nearest exit
+class MapBundle {
+public:
+    static constexpr std::string_view kExtension = ".tdmap";
+
+    // Computes the distance fields for map and writes the bundle.
+    static void write(const Map& map, const std::filesystem::path& path);
+    static Map load(const std::filesystem::path& path);
+};
+
+} // namespace towerdefense
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace towerdefense {
+
+// Per-creature state touched by one movement tick, as parallel arrays of
+// count entries. A lane moves only when its health is positive and its
+// flags contain routed_flag.
+struct MovementLanes {
+    double* progress{nullptr};
+    const double* speed{nullptr};
+    double* slow_factor{nullptr};
+    int* slow_duration{nullptr};
+    const int* health{nullptr};
+    const std::uint8_t* flags{nullptr};
+    std::uint8_t routed_flag{0};
+    std::size_t count{0};
+};
+
+enum class MovementKernel {
+    Scalar,
+    Avx2,
+};
+
+// Widest kernel this CPU runs, detected once.
+[[nodiscard]] MovementKernel best_movement_kernel() noexcept;
+
+// Ticks slow timers and adds speed * slow factor to each moving lane's
+// progress. Writes the index of every moving lane whose progress reached a
+// whole step to steps (which must hold count entries) and returns how many
+// were written, in ascending order. Both kernels produce bit-identical
+// results; asking for Avx2 on a CPU without it runs the scalar kernel.
+std::size_t advance_movement(const MovementLanes& lanes, std::uint32_t* steps, MovementKernel kernel) noexcept;
+
+} // namespace towerdefense
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Route.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace towerdefense {
+
+// Bounded LRU cache of shared routes keyed by exact (start, goal, layer)
+// cell indices. Map changes bump a generation instead of clearing; entries
+// from older generations are dropped lazily when touched or evicted.
+class PathCache {
+public:
+    static constexpr std::size_t kDefaultMemoryBudget = 4u * 1024u * 1024u;
+
+    struct Stats {
+        std::size_t hits{};
+        std::size_t misses{};
+        std::size_t evictions{};
+        std::size_t expired{};
+    };
+
+    explicit PathCache(std::size_t memory_budget_bytes = kDefaultMemoryBudget);
+
+    // Cell ids must be below 2^31, which covers any map that fits in memory.
+    [[nodiscard]] static std::uint64_t make_key(CellId start_cell, CellId goal_cell, bool ignore_towers) noexcept;
+
+    // Returns nullptr on a miss. A null handle is a cached "no route" result.
+    [[nodiscard]] const RouteHandle* find(std::uint64_t key);
+    void insert(std::uint64_t key, RouteHandle route);
+    void advance_generation() noexcept { ++generation_; }
+    void clear();
+
+    void set_memory_budget(std::size_t bytes);
+    [[nodiscard]] std::size_t memory_budget() const noexcept { return memory_budget_; }
+    [[nodiscard]] std::size_t memory_usage() const noexcept { return memory_usage_; }
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+    void reset_stats() noexcept { stats_ = Stats{}; }
+
+private:
+    struct Entry {
+        std::uint64_t key{};
+        std::uint64_t generation{};
+        RouteHandle route{};
+    };
+    using EntryList = std::list<Entry>;
+
+    EntryList entries_{};
+    std::unordered_map<std::uint64_t, EntryList::iterator> index_{};
+    std::uint64_t generation_{0};
+    std::size_t memory_budget_{};
+    std::size_t memory_usage_{0};
+    Stats stats_{};
+
+    [[nodiscard]] static std::size_t footprint(const Entry& entry) noexcept;
+    void erase(EntryList::iterator it);
+    void enforce_budget();
+};
+
+} // namespace towerdefense
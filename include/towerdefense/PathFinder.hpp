@@ -1,10 +1,15 @@
 #pragma once
 
 #include "GridPosition.hpp"
+#include "HierarchicalPathFinder.hpp"
+#include "JumpPointSearch.hpp"
 #include "Map.hpp"
+#include "PathCache.hpp"
 
+#include <cstdint>
 #include <deque>
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -13,22 +18,67 @@ namespace towerdefense {
 
 class PathFinder {
 public:
-    explicit PathFinder(const Map& map);
+    // Automatic answers single-goal searches with jump point search, and
+    // switches to the hierarchical layer once the map has at least
+    // kHierarchicalThreshold cells. Hierarchical paths are near-shortest, so
+    // callers that need exact lengths ask for Flat or JumpPoint.
+    enum class Strategy {
+        Automatic,
+        Flat,
+        JumpPoint,
+        Hierarchical,
+    };
+
+    static constexpr std::size_t kHierarchicalThreshold = 512 * 512;
+
+    explicit PathFinder(const Map& map, std::size_t cache_budget_bytes = PathCache::kDefaultMemoryBudget,
+        Strategy strategy = Strategy::Automatic);
 
     [[nodiscard]] std::optional<std::vector<GridPosition>> shortest_path(
         const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze = false);
+    // Same search, handing out the cached route itself instead of a copy.
+    // Returns nullptr when no route exists.
+    [[nodiscard]] RouteHandle shortest_route(
+        const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze = false);
+    // Single search towards whichever goal is closest. Ties go to the goal
+    // listed first, matching a shortest_path call per goal.
+    [[nodiscard]] std::optional<std::vector<GridPosition>> shortest_path_to_any(
+        const GridPosition& start, std::span<const GridPosition> goals, bool allow_tower_squeeze = false);
 
+    // Call after a single cell changed; only the clusters around it are
+    // rebuilt. invalidate_cache() treats the whole map as changed.
+    void update_cell(const GridPosition& position);
     void invalidate_cache();
+    [[nodiscard]] bool is_hierarchical() const noexcept { return hierarchy_.has_value(); }
+    void set_cache_budget(std::size_t bytes) { cache_.set_memory_budget(bytes); }
+    [[nodiscard]] const PathCache::Stats& cache_stats() const noexcept { return cache_.stats(); }
+    [[nodiscard]] std::size_t cache_memory_usage() const noexcept { return cache_.memory_usage(); }
 
 private:
     using Path = std::vector<GridPosition>;
 
+    // Reusable search buffers sized to the map. A cell counts as visited when
+    // its stamp equals the current generation, so nothing is cleared between
+    // searches.
+    struct Scratch {
+        std::vector<std::uint32_t> visited_generation{};
+        std::vector<CellId> came_from{};
+        std::vector<CellId> frontier{};
+        std::vector<std::uint32_t> goal_generation{};
+        std::vector<std::uint32_t> goal_rank{};
+        std::uint32_t generation{0};
+    };
+
     const Map* map_{nullptr};
-    std::unordered_map<std::size_t, Path> cache_{};
-    std::size_t cache_version_{0};
+    PathCache cache_;
+    Scratch scratch_{};
+    std::optional<JumpPointSearch> jump_points_{};
+    std::optional<HierarchicalPathFinder> hierarchy_{};
 
-    [[nodiscard]] std::size_t compute_cache_key(const GridPosition& start, const GridPosition& goal, bool ignore_towers) const noexcept;
-    [[nodiscard]] std::optional<Path> bfs(const GridPosition& start, const GridPosition& goal, bool ignore_towers) const;
+    [[nodiscard]] std::uint64_t compute_cache_key(const GridPosition& start, const GridPosition& goal, bool ignore_towers) const noexcept;
+    [[nodiscard]] std::optional<Path> bfs(
+        const GridPosition& start, std::span<const GridPosition> goals, bool ignore_towers);
+    void prepare_scratch();
 };
 
 } // namespace towerdefense
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GridPosition.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace towerdefense {
+
+class Route;
+using RouteHandle = std::shared_ptr<const Route>;
+
+// Immutable walk across the grid, stored as its first cell plus one 2-bit
+// direction code per step. Creatures on the same route share one instance
+// and only keep their own step index.
+class Route {
+public:
+    explicit Route(const std::vector<GridPosition>& positions);
+
+    [[nodiscard]] static RouteHandle from_positions(const std::vector<GridPosition>& positions);
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] const GridPosition& front() const noexcept { return start_; }
+    [[nodiscard]] const GridPosition& back() const noexcept { return goal_; }
+    // Cell at index + 1, given the cell at index.
+    [[nodiscard]] GridPosition next(const GridPosition& current, std::size_t index) const noexcept;
+    [[nodiscard]] std::vector<GridPosition> to_positions() const;
+    [[nodiscard]] std::size_t memory_footprint() const noexcept;
+
+private:
+    static constexpr std::size_t kStepsPerWord = 32;
+
+    GridPosition start_{};
+    GridPosition goal_{};
+    std::size_t size_{};
+    std::vector<std::uint64_t> steps_{};
+    // Only used when the input skips cells and cannot be direction-coded.
+    std::vector<GridPosition> waypoints_{};
+};
+
+} // namespace towerdefense
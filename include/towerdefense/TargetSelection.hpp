@@ -0,0 +1,50 @@
+#pragma once
+
+#include "GridPosition.hpp"
+#include "Tower.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace towerdefense {
+
+// Squared distance in whole cells, saturated to 32 bits. Orders candidates
+// the same way distance() does without a square root.
+[[nodiscard]] inline std::uint32_t squared_cell_distance(const GridPosition& lhs, const GridPosition& rhs) noexcept {
+    const std::uint64_t dx = lhs.x > rhs.x ? lhs.x - rhs.x : rhs.x - lhs.x;
+    const std::uint64_t dy = lhs.y > rhs.y ? lhs.y - rhs.y : rhs.y - lhs.y;
+    if (dx > 0xFFFFu || dy > 0xFFFFu) {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(dx * dx + dy * dy, std::numeric_limits<std::uint32_t>::max()));
+}
+
+// Whether a candidate outranks the best so far. Equal keys go to the older
+// creature, by spawn sequence, for Nearest and to the newer one otherwise,
+// the order Tower has always broken ties in. Candidates may come in any
+// order.
+template <TargetingMode Mode>
+[[nodiscard]] constexpr bool outranks(
+    std::uint32_t key, std::uint64_t spawn, std::uint32_t best_key, std::uint64_t best_spawn) noexcept {
+    if (key != best_key) {
+        return Mode == TargetingMode::Nearest || Mode == TargetingMode::Weakest ? key < best_key : key > best_key;
+    }
+    return Mode == TargetingMode::Nearest ? spawn < best_spawn : spawn > best_spawn;
+}
+
+// Picks one of count candidates for the targeting mode and returns its
+// position; count must be positive. Keys are squared distances for
+// Nearest/Farthest and health for Strongest/Weakest, spawns the creatures'
+// spawn sequences; the winner is the one outranks() puts first. Uses AVX2
+// when the CPU has it.
+template <TargetingMode Mode>
+[[nodiscard]] std::size_t select_best(const std::uint32_t* keys, const std::uint64_t* spawns, std::size_t count) noexcept;
+
+extern template std::size_t select_best<TargetingMode::Nearest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+extern template std::size_t select_best<TargetingMode::Farthest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+extern template std::size_t select_best<TargetingMode::Strongest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+extern template std::size_t select_best<TargetingMode::Weakest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+
+} // namespace towerdefense
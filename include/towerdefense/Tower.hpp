@@ -2,15 +2,20 @@
 
 #include "GridPosition.hpp"
 #include "Materials.hpp"
+#include "TowerCoverage.hpp"
 
 #include <cstddef>
-#include <memory>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace towerdefense {
 
-class Creature;
+class CreatureGrid;
+class CreatureStore;
+class TowerStore;
 
 enum class TargetingMode {
     Nearest,
@@ -19,6 +24,20 @@ enum class TargetingMode {
     Weakest
 };
 
+// What a tower does when it fires. Each kind is stored and updated as its
+// own batch by TowerStore.
+enum class TowerKind : std::uint8_t {
+    Ballista,
+    Mortar,
+    Frostspire,
+    StormTotem,
+    ArcanePrism,
+    TeslaCoil,
+    DruidGrove,
+};
+
+inline constexpr std::size_t kTowerKindCount = 7;
+
 struct TowerLevel {
     std::string label;
     int damage{};
@@ -28,23 +47,30 @@ struct TowerLevel {
     Materials upgrade_cost{};
 };
 
+// Buffers reused across target acquisitions. One set, owned by whoever
+// fires the towers, serves every tower in a tick.
+struct TargetScratch {
+    std::vector<std::size_t> candidates{};
+    std::vector<std::uint32_t> keys{};
+    std::vector<std::uint64_t> spawns{};
+};
+
 class Tower {
 public:
-    Tower(std::string id, std::string name, GridPosition position, TargetingMode targeting_mode,
+    Tower(TowerKind kind, std::string id, std::string name, GridPosition position, TargetingMode targeting_mode,
         std::vector<TowerLevel> levels, std::string projectile_behavior);
-    virtual ~Tower() = default;
 
     Tower(const Tower&) = delete;
     Tower& operator=(const Tower&) = delete;
     Tower(Tower&&) noexcept = default;
     Tower& operator=(Tower&&) noexcept = default;
 
-    virtual bool attack(std::vector<Creature>& creatures) = 0;
     void tick();
 
     [[nodiscard]] bool can_attack() const noexcept { return cooldown_ == 0; }
     void reset_cooldown();
 
+    [[nodiscard]] TowerKind kind() const noexcept { return kind_; }
     [[nodiscard]] const std::string& name() const noexcept { return name_; }
     [[nodiscard]] const std::string& id() const noexcept { return id_; }
     [[nodiscard]] const GridPosition& position() const noexcept { return position_; }
@@ -60,15 +86,40 @@ public:
     [[nodiscard]] const Materials& invested_materials() const noexcept { return invested_materials_; }
     void set_targeting_mode(TargetingMode mode) noexcept { targeting_mode_ = mode; }
     [[nodiscard]] TargetingMode targeting_mode() const noexcept { return targeting_mode_; }
-
-protected:
-    [[nodiscard]] std::vector<Creature*> targets_in_range(std::vector<Creature>& creatures) const;
-    [[nodiscard]] std::vector<Creature*> targets_in_radius(
-        std::vector<Creature>& creatures, const GridPosition& origin, double radius) const;
-    [[nodiscard]] Creature* select_target(std::vector<Creature*>& candidates) const;
-    [[nodiscard]] Creature* select_target(std::vector<Creature*>& candidates, TargetingMode mode) const;
+    // Built by TowerStore::refresh_coverage.
+    [[nodiscard]] const TowerCoverage& coverage() const noexcept { return coverage_; }
+
+private:
+    // TowerStore runs the per-kind attack code against these.
+    friend class TowerStore;
+
+    // Candidates are creature indices into the store, in no particular
+    // order. The returned spans view scratch and last until its next use.
+    [[nodiscard]] std::span<const std::size_t> targets_in_range(
+        const CreatureStore& creatures, const CreatureGrid& grid, TargetScratch& scratch) const;
+    [[nodiscard]] std::span<const std::size_t> targets_in_radius(const CreatureStore& creatures,
+        const CreatureGrid& grid, const GridPosition& origin, double radius, TargetScratch& scratch) const;
+    [[nodiscard]] std::optional<std::size_t> select_target(const CreatureStore& creatures,
+        std::span<const std::size_t> candidates, TargetingMode mode, TargetScratch& scratch) const;
+    // Picks the target for mode among the creatures in range. With current
+    // coverage Nearest and Farthest build no candidate list: they scan the
+    // covered cells and stop at the first occupied ring.
+    [[nodiscard]] std::optional<std::size_t> acquire_target(
+        const CreatureStore& creatures, const CreatureGrid& grid, TargetingMode mode, TargetScratch& scratch) const;
     void refresh_stats();
 
+    // Gathers each candidate's key for Mode into scratch and runs the
+    // selection kernel over them.
+    template <TargetingMode Mode>
+    [[nodiscard]] std::size_t pick_target(
+        const CreatureStore& creatures, std::span<const std::size_t> candidates, TargetScratch& scratch) const;
+    template <TargetingMode Mode>
+    [[nodiscard]] std::optional<std::size_t> scan_coverage(const CreatureStore& creatures, const CreatureGrid& grid) const;
+    template <TargetingMode Mode>
+    [[nodiscard]] std::uint32_t target_key(const CreatureStore& creatures, std::size_t index) const noexcept;
+    [[nodiscard]] bool in_range(const GridPosition& position) const noexcept;
+
+    TowerKind kind_;
     std::string id_;
     std::string name_;
     GridPosition position_{};
@@ -82,10 +133,9 @@ protected:
     std::size_t level_index_{0};
     std::string projectile_behavior_;
     Materials invested_materials_{};
+    TowerCoverage coverage_{};
 };
 
-using TowerPtr = std::unique_ptr<Tower>;
-
 double distance(const GridPosition& lhs, const GridPosition& rhs) noexcept;
 
 } // namespace towerdefense
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "GridPosition.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace towerdefense {
+
+class Map;
+
+// The cells within a tower's range that creatures can stand on, walking or
+// squeezing past towers. Range only changes on upgrade and walkability
+// only with the map, so the list is built once per map version and lets
+// target acquisition skip every cell that cannot hold an enemy.
+class TowerCoverage {
+public:
+    struct Cell {
+        CellId cell{kInvalidCell};
+        std::uint32_t squared_distance{0};
+    };
+
+    void build(const Map& map, const GridPosition& origin, double range, std::size_t map_version);
+
+    [[nodiscard]] bool is_built_for(double range) const noexcept { return map_version_ && range_ == range; }
+    [[nodiscard]] bool is_current(std::size_t map_version, double range) const noexcept {
+        return map_version_ == map_version && range_ == range;
+    }
+
+    // Nearest first; equal distances in cell order.
+    [[nodiscard]] std::span<const Cell> by_distance() const noexcept { return by_distance_; }
+
+private:
+    std::vector<Cell> by_distance_{};
+    double range_{0.0};
+    std::optional<std::size_t> map_version_{};
+};
+
+} // namespace towerdefense
@@ -22,7 +22,7 @@ struct TowerArchetype {
 
 class TowerFactory {
 public:
-    static TowerPtr create(std::string_view type, const GridPosition& position);
+    static Tower create(std::string_view type, const GridPosition& position);
     static Materials cost(std::string_view type);
     static void list_available(std::ostream& os);
     static const std::vector<TowerArchetype>& archetypes();
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Tower.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace towerdefense {
+
+class CreatureGrid;
+class CreatureStore;
+class Map;
+
+// Names one tower for as long as it stands. A handle goes stale when its
+// tower is removed; a later tower reusing the slot gets a new generation.
+struct TowerHandle {
+    std::uint32_t index{0};
+    std::uint32_t generation{0};
+
+    [[nodiscard]] bool operator==(const TowerHandle& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+    [[nodiscard]] bool operator!=(const TowerHandle& other) const noexcept { return !(*this == other); }
+};
+
+// Towers stored contiguously per kind, so a tick fires every tower of one
+// kind through the same statically dispatched code. Removal swaps the last
+// tower of the kind into the gap; handles stay valid across that, raw
+// pointers and references do not survive an insert or erase.
+class TowerStore {
+public:
+    class Iterator;
+
+    [[nodiscard]] std::size_t size() const noexcept { return slots_.size() - free_slots_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    TowerHandle insert(Tower tower);
+    // Returns false when the handle is stale.
+    bool erase(TowerHandle handle);
+
+    // nullptr when the handle is stale.
+    [[nodiscard]] Tower* find(TowerHandle handle) noexcept;
+    [[nodiscard]] const Tower* find(TowerHandle handle) const noexcept;
+    // Current handle of an occupied slot.
+    [[nodiscard]] TowerHandle handle(std::uint32_t slot) const noexcept { return TowerHandle{slot, slots_[slot].generation}; }
+
+    [[nodiscard]] const std::vector<Tower>& of_kind(TowerKind kind) const noexcept {
+        return towers_[static_cast<std::size_t>(kind)];
+    }
+
+    // Rebuilds the coverage of every tower whose range or map version it
+    // was not built for.
+    void refresh_coverage(const Map& map, std::size_t map_version);
+
+    // Cools every tower down one tick and fires the ready ones, a kind at a
+    // time.
+    void attack_all(CreatureStore& creatures, const CreatureGrid& grid);
+
+    // Every tower, grouped by kind.
+    [[nodiscard]] Iterator begin() const noexcept;
+    [[nodiscard]] Iterator end() const noexcept;
+
+private:
+    static constexpr std::uint32_t kVacant = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::uint32_t generation{0};
+        // Position within towers_[kind], or kVacant.
+        std::uint32_t position{kVacant};
+        TowerKind kind{TowerKind::Ballista};
+    };
+
+    std::array<std::vector<Tower>, kTowerKindCount> towers_{};
+    // Slot of each tower, parallel to towers_.
+    std::array<std::vector<std::uint32_t>, kTowerKindCount> owners_{};
+    std::vector<Slot> slots_{};
+    std::vector<std::uint32_t> free_slots_{};
+    // Shared by every tower that fires, so a tick allocates nothing once
+    // the buffers have grown.
+    TargetScratch scratch_{};
+
+    template <TowerKind Kind>
+    void attack_kind(CreatureStore& creatures, const CreatureGrid& grid);
+    template <TowerKind Kind>
+    static bool fire(Tower& tower, CreatureStore& creatures, const CreatureGrid& grid, TargetScratch& scratch);
+};
+
+class TowerStore::Iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Tower;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Tower*;
+    using reference = const Tower&;
+
+    Iterator() = default;
+    Iterator(const TowerStore& store, std::size_t kind, std::size_t position) noexcept
+        : store_(&store)
+        , kind_(kind)
+        , position_(position) {
+        skip_empty();
+    }
+
+    [[nodiscard]] const Tower& operator*() const noexcept { return store_->towers_[kind_][position_]; }
+    [[nodiscard]] const Tower* operator->() const noexcept { return &**this; }
+    Iterator& operator++() noexcept {
+        ++position_;
+        skip_empty();
+        return *this;
+    }
+    Iterator operator++(int) noexcept {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+    [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+        return kind_ == other.kind_ && position_ == other.position_;
+    }
+    [[nodiscard]] bool operator!=(const Iterator& other) const noexcept { return !(*this == other); }
+
+private:
+    const TowerStore* store_{nullptr};
+    std::size_t kind_{kTowerKindCount};
+    std::size_t position_{0};
+
+    void skip_empty() noexcept {
+        while (kind_ < kTowerKindCount && position_ >= store_->towers_[kind_].size()) {
+            ++kind_;
+            position_ = 0;
+        }
+    }
+};
+
+inline TowerStore::Iterator TowerStore::begin() const noexcept {
+    return Iterator{*this, 0, 0};
+}
+
+inline TowerStore::Iterator TowerStore::end() const noexcept {
+    return Iterator{*this, kTowerKindCount, 0};
+}
+
+} // namespace towerdefense
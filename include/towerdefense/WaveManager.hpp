@@ -1,5 +1,6 @@
 #pragma once
 
+#include "CreatureBlueprint.hpp"
 #include "Materials.hpp"
 
 #include <filesystem>
@@ -13,18 +14,6 @@ namespace towerdefense {
 
 class Game;
 
-struct CreatureBlueprint {
-    std::string id;
-    std::string name;
-    int max_health{};
-    double speed{};
-    Materials reward;
-    int armor{0};
-    int shield{0};
-    bool flying{false};
-    std::vector<std::string> behaviors;
-};
-
 struct EnemyGroupDefinition {
     std::string creature_id;
     std::string creature_name;
@@ -62,14 +51,14 @@ public:
 
 private:
     std::filesystem::path waves_root_{};
-    std::unordered_map<std::string, CreatureBlueprint> creatures_{};
+    std::unordered_map<std::string, BlueprintHandle> creatures_{};
     std::vector<WaveDefinition> waves_{};
     std::size_t next_wave_index_{0};
     std::mt19937 rng_{std::random_device{}()};
 
     void load_from_file(const std::filesystem::path& file_path);
     void load_default_definitions();
-    CreatureBlueprint build_default_creature(std::string id, std::string name, int health, double speed, Materials reward,
+    BlueprintHandle build_default_creature(std::string id, std::string name, int health, double speed, Materials reward,
         int armor, int shield, bool flying, std::vector<std::string> behaviors);
     WaveDefinition build_default_wave(std::string name, std::vector<EnemyGroupDefinition> groups, int spawn_interval, int delay = 0);
 };
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace towerdefense {
+
+// Fixed set of worker threads for data-parallel loops. Threads are started on
+// the first loop large enough to need them; the calling thread always takes a
+// share of the work, so a pool of size 1 simply runs inline.
+class WorkerPool {
+public:
+    // Range task: (begin, end, worker). Worker ids are in [0, size()).
+    using Task = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+    // 0 picks one worker per hardware thread.
+    explicit WorkerPool(std::size_t worker_count = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    [[nodiscard]] std::size_t size() const noexcept { return worker_count_; }
+
+    // Splits [0, count) into chunks of at least min_chunk items and blocks
+    // until every chunk ran. The first exception thrown by a task is
+    // rethrown here after the loop drains.
+    void parallel_for(std::size_t count, std::size_t min_chunk, const Task& task);
+
+private:
+    std::size_t worker_count_{1};
+    std::vector<std::thread> threads_{};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Task* task_{nullptr};
+    std::size_t count_{};
+    std::size_t chunk_{};
+    std::size_t next_chunk_{};
+    std::size_t active_{};
+    std::size_t job_{};
+    bool stopping_{false};
+    std::exception_ptr error_{};
+
+    void start_threads();
+    void worker_loop(std::size_t worker);
+    void drain(std::unique_lock<std::mutex>& lock, std::size_t worker);
+};
+
+} // namespace towerdefense
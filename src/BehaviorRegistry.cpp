@@ -0,0 +1,46 @@
+#include "towerdefense/BehaviorRegistry.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace towerdefense {
+
+namespace {
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names{"burrower", "destroyer"};
+    std::unordered_map<std::string, std::size_t> bits{{"burrower", 0}, {"destroyer", 1}};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+} // namespace
+
+BehaviorMask BehaviorRegistry::intern(std::string_view name) {
+    auto& state = registry();
+    std::lock_guard lock{state.mutex};
+    const std::string key{name};
+    if (const auto it = state.bits.find(key); it != state.bits.end()) {
+        return BehaviorMask{1} << it->second;
+    }
+    if (state.names.size() >= kCapacity) {
+        throw std::runtime_error("Too many distinct creature behaviors: " + key);
+    }
+    const std::size_t bit = state.names.size();
+    state.names.push_back(key);
+    state.bits.emplace(key, bit);
+    return BehaviorMask{1} << bit;
+}
+
+BehaviorMask BehaviorRegistry::intern(const std::vector<std::string>& names) {
+    BehaviorMask mask = 0;
+    for (const auto& name : names) {
+        mask |= intern(name);
+    }
+    return mask;
+}
+
+} // namespace towerdefense
@@ -0,0 +1,132 @@
+#include "towerdefense/ConnectivityIndex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace towerdefense {
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+} // namespace
+
+void ConnectivityIndex::rebuild(const Map& map) {
+    width_ = map.width();
+    height_ = map.height();
+    critical_.assign(width_ * height_, 0);
+    connected_ = false;
+    if (map.entries().empty()) {
+        return;
+    }
+    const auto& resource = map.resource_position();
+    if (!map.is_walkable(resource)) {
+        return;
+    }
+    if (!mark_cuts(map, map.entries())) {
+        return;
+    }
+    if (!map.exits().empty() && !mark_cuts(map, map.exits())) {
+        return;
+    }
+    critical_[to_cell_id(resource, width_)] = 1;
+    connected_ = true;
+}
+
+bool ConnectivityIndex::would_disconnect(const GridPosition& pos) const noexcept {
+    if (!connected_ || pos.x >= width_ || pos.y >= height_) {
+        return true;
+    }
+    return critical_[to_cell_id(pos, width_)] != 0;
+}
+
+bool ConnectivityIndex::mark_cuts(const Map& map, const std::vector<GridPosition>& sources) {
+    // Depth-first search rooted at the resource over the walkable cells plus
+    // one virtual node joined to every source. A cell on the tree path from
+    // the virtual node back to the resource separates them exactly when the
+    // subtree below it has no back edge climbing above it.
+    const std::size_t cells = width_ * height_;
+    const auto virtual_node = static_cast<std::uint32_t>(cells);
+    discovery_.assign(cells + 1, 0);
+    low_.assign(cells + 1, 0);
+    parent_.assign(cells + 1, kNone);
+    next_edge_.assign(cells, 0);
+    is_source_.assign(cells, 0);
+    std::vector<std::uint32_t> source_cells;
+    for (const auto& source : sources) {
+        if (map.is_walkable(source)) {
+            const auto cell = to_cell_id(source, width_);
+            is_source_[cell] = 1;
+            source_cells.push_back(cell);
+        }
+    }
+
+    // Returns the next unexplored edge of a node, or kNone once exhausted.
+    std::size_t virtual_edge = 0;
+    auto next_neighbor = [&](std::uint32_t node) -> std::uint32_t {
+        if (node == virtual_node) {
+            if (virtual_edge >= source_cells.size()) {
+                return kNone;
+            }
+            return source_cells[virtual_edge++];
+        }
+        auto& edge = next_edge_[node];
+        const std::size_t x = node % width_;
+        const std::size_t y = node / width_;
+        while (edge < directions.size()) {
+            const auto [dx, dy] = directions[edge++];
+            const int next_x = static_cast<int>(x) + dx;
+            const int next_y = static_cast<int>(y) + dy;
+            if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(width_) || next_y >= static_cast<int>(height_)) {
+                continue;
+            }
+            const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
+            if (map.is_walkable(next)) {
+                return to_cell_id(next, width_);
+            }
+        }
+        if (edge == directions.size()) {
+            ++edge;
+            if (is_source_[node]) {
+                return virtual_node;
+            }
+        }
+        return kNone;
+    };
+
+    const auto& resource = map.resource_position();
+    const auto root = to_cell_id(resource, width_);
+    std::uint32_t time = 0;
+    std::vector<std::uint32_t> stack{root};
+    discovery_[root] = low_[root] = ++time;
+    while (!stack.empty()) {
+        const std::uint32_t node = stack.back();
+        const std::uint32_t next = next_neighbor(node);
+        if (next == kNone) {
+            stack.pop_back();
+            if (parent_[node] != kNone) {
+                low_[parent_[node]] = std::min(low_[parent_[node]], low_[node]);
+            }
+            continue;
+        }
+        if (discovery_[next] == 0) {
+            parent_[next] = node;
+            discovery_[next] = low_[next] = ++time;
+            stack.push_back(next);
+        } else if (next != parent_[node]) {
+            low_[node] = std::min(low_[node], discovery_[next]);
+        }
+    }
+
+    if (discovery_[virtual_node] == 0) {
+        return false;
+    }
+    for (std::uint32_t child = virtual_node, node = parent_[virtual_node]; node != root; child = node, node = parent_[node]) {
+        if (low_[child] >= discovery_[node]) {
+            critical_[node] = 1;
+        }
+    }
+    return true;
+}
+
+} // namespace towerdefense
@@ -0,0 +1,34 @@
+#include "towerdefense/CpuFeatures.hpp"
+
+#if defined(TOWERDEFENSE_X86_KERNELS) && !defined(__GNUC__) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace towerdefense {
+
+namespace {
+bool detect_avx2() noexcept {
+#if defined(TOWERDEFENSE_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(TOWERDEFENSE_X86_KERNELS)
+    int info[4]{};
+    __cpuid(info, 1);
+    const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    if (!os_saves_ymm) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+} // namespace
+
+bool cpu_has_avx2() noexcept {
+    static const bool supported = detect_avx2();
+    return supported;
+}
+
+} // namespace towerdefense
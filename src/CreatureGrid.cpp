@@ -0,0 +1,122 @@
+#include "towerdefense/CreatureGrid.hpp"
+
+#include "towerdefense/Map.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace towerdefense {
+
+namespace {
+constexpr std::uint32_t kNoBucket = std::numeric_limits<std::uint32_t>::max();
+} // namespace
+
+CreatureGrid::CreatureGrid(std::size_t width, std::size_t height)
+    : width_(width)
+    , height_(height)
+    , buckets_x_((std::max<std::size_t>(width, 1) + kBucketSize - 1) / kBucketSize)
+    , buckets_y_((std::max<std::size_t>(height, 1) + kBucketSize - 1) / kBucketSize)
+    , starts_(buckets_x_ * buckets_y_ + 1, 0)
+    , cell_starts_(width * height + 1, 0) {}
+
+std::size_t CreatureGrid::bucket_column(std::size_t x) const noexcept {
+    return std::min(x / kBucketSize, buckets_x_ - 1);
+}
+
+std::size_t CreatureGrid::bucket_row(std::size_t y) const noexcept {
+    return std::min(y / kBucketSize, buckets_y_ - 1);
+}
+
+void CreatureGrid::rebuild(const CreatureStore& creatures, const Map& map) {
+    if (buckets_x_ == 0) {
+        return;
+    }
+    // Counting sort: count per bucket and per cell, prefix sum, then place
+    // creatures in index order so every bucket and cell comes out sorted.
+    const std::size_t slots = creatures.slot_count();
+    bucket_of_.resize(slots);
+    cell_of_.resize(slots);
+    std::fill(starts_.begin(), starts_.end(), 0);
+    std::fill(cell_starts_.begin(), cell_starts_.end(), 0);
+    strays_.clear();
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < slots; ++i) {
+        if (!creatures.is_alive(i) || creatures.has_exited(i)) {
+            bucket_of_[i] = kNoBucket;
+            cell_of_[i] = kInvalidCell;
+            continue;
+        }
+        const GridPosition& position = creatures.position(i);
+        const std::size_t bucket = bucket_row(position.y) * buckets_x_ + bucket_column(position.x);
+        bucket_of_[i] = static_cast<std::uint32_t>(bucket);
+        ++starts_[bucket + 1];
+        ++total;
+        const bool in_bounds = position.x < width_ && position.y < height_;
+        cell_of_[i] = in_bounds ? to_cell_id(position, width_) : kInvalidCell;
+        if (in_bounds) {
+            ++cell_starts_[cell_of_[i] + 1];
+        }
+        if (!map.is_walkable(position, true)) {
+            strays_.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    for (std::size_t b = 1; b < starts_.size(); ++b) {
+        starts_[b] += starts_[b - 1];
+    }
+    for (std::size_t c = 1; c < cell_starts_.size(); ++c) {
+        cell_starts_[c] += cell_starts_[c - 1];
+    }
+    entries_.resize(total);
+    cell_entries_.resize(cell_starts_.back());
+    // starts_[b] doubles as bucket b's write cursor and ends up at the
+    // bucket's end, i.e. the next bucket's start; shifting restores it.
+    // Cells work the same way.
+    for (std::size_t i = 0; i < slots; ++i) {
+        if (bucket_of_[i] != kNoBucket) {
+            entries_[starts_[bucket_of_[i]]++] = static_cast<std::uint32_t>(i);
+        }
+        if (cell_of_[i] != kInvalidCell) {
+            cell_entries_[cell_starts_[cell_of_[i]]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    std::copy_backward(starts_.begin(), starts_.end() - 1, starts_.end());
+    starts_[0] = 0;
+    std::copy_backward(cell_starts_.begin(), cell_starts_.end() - 1, cell_starts_.end());
+    cell_starts_[0] = 0;
+}
+
+void CreatureGrid::query(const CreatureStore& creatures, const GridPosition& origin, double radius,
+    std::vector<std::size_t>& out) const {
+    out.clear();
+    if (buckets_x_ == 0 || radius < 0.0) {
+        return;
+    }
+    // Compared squared: the offsets are whole cells, so no square root.
+    const double limit = radius * radius;
+    const auto reach = static_cast<std::size_t>(std::ceil(radius));
+    const std::size_t first_column = bucket_column(origin.x > reach ? origin.x - reach : 0);
+    const std::size_t last_column = bucket_column(origin.x + reach);
+    const std::size_t first_row = bucket_row(origin.y > reach ? origin.y - reach : 0);
+    const std::size_t last_row = bucket_row(origin.y + reach);
+
+    for (std::size_t row = first_row; row <= last_row; ++row) {
+        for (std::size_t column = first_column; column <= last_column; ++column) {
+            const std::size_t bucket = row * buckets_x_ + column;
+            for (std::uint32_t k = starts_[bucket]; k < starts_[bucket + 1]; ++k) {
+                const std::size_t index = entries_[k];
+                if (!creatures.is_alive(index)) {
+                    continue;
+                }
+                const GridPosition& position = creatures.position(index);
+                const double dx = static_cast<double>(position.x) - static_cast<double>(origin.x);
+                const double dy = static_cast<double>(position.y) - static_cast<double>(origin.y);
+                if (dx * dx + dy * dy <= limit) {
+                    out.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+} // namespace towerdefense
@@ -0,0 +1,180 @@
+#include "towerdefense/CreatureStore.hpp"
+
+#include "towerdefense/MovementKernel.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace towerdefense {
+
+CreatureHandle CreatureStore::push(Creature creature) {
+    std::uint8_t flags = 0;
+    flags |= creature.is_flying() ? kFlying : 0;
+    flags |= creature.reached_goal_ ? kReachedGoal : 0;
+    flags |= creature.carrying_resource_ ? kCarrying : 0;
+    flags |= creature.exited_ ? kExited : 0;
+    flags |= creature.route_ ? kRouted : 0;
+
+    std::size_t index = 0;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = slot_count();
+        if (index >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Too many creatures");
+        }
+        const std::size_t count = index + 1;
+        positions_.resize(count);
+        health_.resize(count);
+        shield_.resize(count);
+        speed_.resize(count);
+        progress_.resize(count);
+        slow_factor_.resize(count);
+        slow_duration_.resize(count);
+        segments_.resize(count);
+        routes_.resize(count);
+        flags_.resize(count);
+        behaviors_.resize(count);
+        max_health_.resize(count);
+        blueprints_.resize(count);
+        spawn_sequences_.resize(count);
+        generations_.resize(count);
+        // release() and advance_all() are noexcept, so their buffers are
+        // sized here.
+        if (free_slots_.capacity() < count) {
+            free_slots_.reserve(positions_.capacity());
+        }
+        steps_.resize(count);
+    }
+
+    positions_[index] = creature.current_position_;
+    health_[index] = creature.health_;
+    shield_[index] = creature.shield_health_;
+    speed_[index] = creature.speed_;
+    progress_[index] = creature.movement_progress_;
+    slow_factor_[index] = creature.slow_factor_;
+    slow_duration_[index] = creature.slow_duration_;
+    segments_[index] = creature.segment_index_;
+    routes_[index] = std::move(creature.route_);
+    flags_[index] = flags;
+    behaviors_[index] = creature.behavior_mask();
+    max_health_[index] = creature.max_health_;
+    blueprints_[index] = std::move(creature.blueprint_);
+    spawn_sequences_[index] = next_spawn_sequence_++;
+    if (creature.health_ > 0 && !creature.exited_) {
+        ++alive_count_;
+    }
+    return handle(index);
+}
+
+void CreatureStore::clear() noexcept {
+    for (std::size_t i = 0; i < slot_count(); ++i) {
+        if (is_occupied(i)) {
+            release(i);
+        }
+    }
+}
+
+std::pair<double, double> CreatureStore::interpolated_position(std::size_t index) const noexcept {
+    const GridPosition& a = positions_[index];
+    const auto& route = routes_[index];
+    if (!route) {
+        return {static_cast<double>(a.x), static_cast<double>(a.y)};
+    }
+    const GridPosition b = route->next(a, segments_[index]);
+    const double t = std::clamp(progress_[index], 0.0, 1.0);
+    const double x = static_cast<double>(a.x) + (static_cast<double>(b.x) - static_cast<double>(a.x)) * t;
+    const double y = static_cast<double>(a.y) + (static_cast<double>(b.y) - static_cast<double>(a.y)) * t;
+    return {x, y};
+}
+
+void CreatureStore::assign_path(std::size_t index, RouteHandle route) {
+    if (!route) {
+        throw std::invalid_argument("Path cannot be empty");
+    }
+    positions_[index] = route->front();
+    routes_[index] = std::move(route);
+    segments_[index] = 0;
+    progress_[index] = 0.0;
+    flags_[index] = static_cast<std::uint8_t>((flags_[index] & kFlying) | kRouted);
+}
+
+void CreatureStore::start_returning(std::size_t index, RouteHandle route) {
+    if (!route) {
+        throw std::invalid_argument("Path cannot be empty");
+    }
+    positions_[index] = route->front();
+    routes_[index] = std::move(route);
+    segments_[index] = 0;
+    progress_[index] = 0.0;
+    flags_[index] = static_cast<std::uint8_t>((flags_[index] & kFlying) | kRouted | kReachedGoal | kCarrying);
+}
+
+void CreatureStore::apply_damage(std::size_t index, int amount) {
+    if (amount <= 0 || !is_alive(index)) {
+        return;
+    }
+    int remaining = Creature::roll_damage(amount);
+    int& shield = shield_[index];
+    if (shield > 0) {
+        const int absorbed = std::min(shield, remaining);
+        shield -= absorbed;
+        remaining -= absorbed;
+    }
+    if (remaining <= 0) {
+        return;
+    }
+    const int mitigated = std::max(1, remaining - blueprints_[index]->armor);
+    health_[index] = std::max(0, health_[index] - mitigated);
+    if (health_[index] == 0 && !has_exited(index)) {
+        --alive_count_;
+    }
+}
+
+void CreatureStore::apply_slow(std::size_t index, double factor, int duration) {
+    slow_factor_[index] = std::clamp(factor, 0.1, 1.0);
+    slow_duration_[index] = std::max(slow_duration_[index], duration);
+}
+
+void CreatureStore::advance_all() noexcept {
+    const MovementLanes lanes{progress_.data(), speed_.data(), slow_factor_.data(), slow_duration_.data(), health_.data(),
+        flags_.data(), kRouted, slot_count()};
+    const std::size_t stepping = advance_movement(lanes, steps_.data(), best_movement_kernel());
+    // Only creatures that crossed into a new cell walk their route.
+    for (std::size_t k = 0; k < stepping; ++k) {
+        const std::size_t i = steps_[k];
+        const Route& route = *routes_[i];
+        double progress = progress_[i];
+        GridPosition position = positions_[i];
+        std::uint32_t segment = segments_[i];
+        while (progress >= 1.0 && segment + 1 < route.size()) {
+            progress -= 1.0;
+            position = route.next(position, segment);
+            ++segment;
+        }
+        if (segment + 1 >= route.size()) {
+            position = route.back();
+        }
+        progress_[i] = progress;
+        positions_[i] = position;
+        segments_[i] = segment;
+    }
+}
+
+void CreatureStore::release(std::size_t index) noexcept {
+    if (is_alive(index) && !has_exited(index)) {
+        --alive_count_;
+    }
+    health_[index] = 0;
+    shield_[index] = 0;
+    routes_[index].reset();
+    blueprints_[index].reset();
+    behaviors_[index] = 0;
+    flags_[index] = kVacant;
+    ++generations_[index];
+    free_slots_.push_back(static_cast<std::uint32_t>(index));
+}
+
+} // namespace towerdefense
@@ -0,0 +1,387 @@
+#include "towerdefense/FlowField.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace towerdefense {
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+}
+
+FlowField::FlowField(const Map& map)
+    : map_(&map) {}
+
+RouteHandle FlowField::route_to_resource(const GridPosition& start, bool allow_tower_squeeze) {
+    return route_to_goal(Goal::Resource, start, allow_tower_squeeze);
+}
+
+RouteHandle FlowField::route_to_nearest_exit(const GridPosition& start, bool allow_tower_squeeze) {
+    return route_to_goal(Goal::NearestExit, start, allow_tower_squeeze);
+}
+
+const std::vector<std::uint32_t>& FlowField::resource_distances() {
+    return field(Goal::Resource, false).distance;
+}
+
+const std::vector<std::uint32_t>& FlowField::exit_distances() {
+    return field(Goal::NearestExit, false).distance;
+}
+
+void FlowField::preload(std::span<const std::uint32_t> to_resource, std::span<const std::uint32_t> to_exit) {
+    const std::size_t cells = map_->width() * map_->height();
+    if (to_resource.size() != cells || to_exit.size() != cells) {
+        throw std::invalid_argument("Preloaded distance fields do not match the map size");
+    }
+    // Without towers on the map both layers of a goal are the same field.
+    const auto walkable = map_->plane(Map::Plane::Walkable);
+    const auto ignoring_towers = map_->plane(Map::Plane::WalkableIgnoringTowers);
+    const bool tower_free = std::equal(walkable.begin(), walkable.end(), ignoring_towers.begin(), ignoring_towers.end());
+    for (const auto goal : {Goal::Resource, Goal::NearestExit}) {
+        const auto source = goal == Goal::Resource ? to_resource : to_exit;
+        for (const bool ignore_towers : {false, true}) {
+            auto& layer = fields_[static_cast<std::size_t>(goal) * 2 + (ignore_towers ? 1 : 0)];
+            if (ignore_towers && !tower_free) {
+                layer.valid = false;
+                continue;
+            }
+            layer.distance.assign(source.begin(), source.end());
+            layer.routes.clear();
+            layer.valid = true;
+        }
+    }
+}
+
+void FlowField::update_cell(const GridPosition& position) {
+    if (!map_->is_within_bounds(position)) {
+        return;
+    }
+    const auto cell = map_->cell_id(position);
+    for (std::size_t slot = 0; slot < fields_.size(); ++slot) {
+        auto& field = fields_[slot];
+        if (!field.valid) {
+            continue;
+        }
+        const auto goal = static_cast<Goal>(slot / 2);
+        const bool ignore_towers = (slot % 2) == 1;
+        if (is_goal_cell(goal, position)) {
+            field.valid = false;
+            continue;
+        }
+        const bool walkable = map_->is_walkable(position, ignore_towers);
+        const bool reached = field.distance[cell] != kUnreachable;
+        if (!walkable && reached) {
+            repair_blocked(field, cell, ignore_towers);
+            field.routes.clear();
+        } else if (walkable && !reached) {
+            repair_opened(field, cell, ignore_towers);
+            field.routes.clear();
+        }
+    }
+}
+
+void FlowField::invalidate() {
+    for (auto& field : fields_) {
+        field.valid = false;
+    }
+}
+
+FlowField::Field& FlowField::field(Goal goal, bool ignore_towers) {
+    auto& field = fields_[static_cast<std::size_t>(goal) * 2 + (ignore_towers ? 1 : 0)];
+    if (!field.valid) {
+        build(field, goal, ignore_towers);
+    }
+    return field;
+}
+
+void FlowField::route_batch(
+    std::span<const RouteRequest> requests, std::span<RouteHandle> results, WorkerPool& workers) {
+    struct Job {
+        std::size_t slot{};
+        GridPosition start{};
+        RouteHandle route{};
+    };
+    constexpr std::size_t kNoJob = static_cast<std::size_t>(-1);
+
+    // Serial pass: build fields, answer pooled routes and collect one job
+    // per distinct (layer, start cell).
+    std::vector<Job> jobs;
+    std::vector<std::size_t> job_of(requests.size(), kNoJob);
+    std::unordered_map<std::uint64_t, std::size_t> job_index;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        const auto goal = request.to_nearest_exit ? Goal::NearestExit : Goal::Resource;
+        const auto slot = reaching_slot(goal, request.start, request.allow_tower_squeeze);
+        results[i] = nullptr;
+        if (!slot) {
+            continue;
+        }
+        const auto start_index = map_->cell_id(request.start);
+        const auto& routes = fields_[*slot].routes;
+        if (const auto pooled = routes.find(start_index); pooled != routes.end()) {
+            results[i] = pooled->second;
+            continue;
+        }
+        const auto key = (static_cast<std::uint64_t>(*slot) << 32) | start_index;
+        const auto [it, inserted] = job_index.emplace(key, jobs.size());
+        if (inserted) {
+            jobs.push_back(Job{*slot, request.start, nullptr});
+        }
+        job_of[i] = it->second;
+    }
+
+    // Parallel pass: fields and map are only read here.
+    trace_scratch_.resize(workers.size());
+    workers.parallel_for(jobs.size(), 16, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        auto& path = trace_scratch_[worker];
+        for (std::size_t j = begin; j < end; ++j) {
+            trace(fields_[jobs[j].slot], jobs[j].start, path);
+            jobs[j].route = Route::from_positions(path);
+        }
+    });
+
+    for (const auto& job : jobs) {
+        const auto start_index = map_->cell_id(job.start);
+        fields_[job.slot].routes.emplace(start_index, job.route);
+    }
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        if (job_of[i] != kNoJob) {
+            results[i] = jobs[job_of[i]].route;
+        }
+    }
+}
+
+std::optional<std::size_t> FlowField::reaching_slot(Goal goal, const GridPosition& start, bool allow_tower_squeeze) {
+    if (!map_->is_within_bounds(start)) {
+        return std::nullopt;
+    }
+    const std::size_t start_index = start.y * map_->width() + start.x;
+    const int attempts = allow_tower_squeeze ? 2 : 1;
+    for (int i = 0; i < attempts; ++i) {
+        if (field(goal, i == 1).distance[start_index] != kUnreachable) {
+            return static_cast<std::size_t>(goal) * 2 + static_cast<std::size_t>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+RouteHandle FlowField::route_to_goal(Goal goal, const GridPosition& start, bool allow_tower_squeeze) {
+    if (const auto slot = reaching_slot(goal, start, allow_tower_squeeze)) {
+        return follow(fields_[*slot], start);
+    }
+    return nullptr;
+}
+
+bool FlowField::is_goal_cell(Goal goal, const GridPosition& position) const {
+    if (goal == Goal::Resource) {
+        return position == map_->resource_position();
+    }
+    const auto& exits = map_->exits();
+    return std::find(exits.begin(), exits.end(), position) != exits.end();
+}
+
+void FlowField::build(Field& field, Goal goal, bool ignore_towers) const {
+    const std::size_t width = map_->width();
+    const std::size_t height = map_->height();
+    field.distance.assign(width * height, kUnreachable);
+    field.routes.clear();
+    field.valid = true;
+
+    // The distance array doubles as the visited set; the frontier is the
+    // cells discovered so far, consumed front to back. Seeding every exit at
+    // once yields the distance to whichever exit is closest.
+    std::vector<CellId> frontier;
+    frontier.reserve(width * height);
+    auto seed = [&](const GridPosition& target) {
+        if (!map_->is_walkable(target, ignore_towers)) {
+            return;
+        }
+        const auto index = to_cell_id(target, width);
+        if (field.distance[index] == 0) {
+            return;
+        }
+        field.distance[index] = 0;
+        frontier.push_back(index);
+    };
+    if (goal == Goal::Resource) {
+        seed(map_->resource_position());
+    } else {
+        for (const auto& exit : map_->exits()) {
+            seed(exit);
+        }
+    }
+
+    propagate(field, frontier, ignore_towers);
+}
+
+void FlowField::repair_blocked(Field& field, CellId cell, bool ignore_towers) const {
+    // Collect every cell that lost all of its downhill neighbours. The queue
+    // is processed level by level, so a cell's parents are settled before it
+    // is examined.
+    std::vector<std::pair<CellId, std::uint32_t>> pending{{cell, field.distance[cell]}};
+    std::vector<CellId> orphaned;
+    field.distance[cell] = kUnreachable;
+    for (std::size_t head = 0; head < pending.size(); ++head) {
+        const auto [current, previous_distance] = pending[head];
+        for_each_neighbor(current, [&](CellId next) {
+            if (field.distance[next] != previous_distance + 1) {
+                return;
+            }
+            bool supported = false;
+            for_each_neighbor(next, [&](CellId parent) {
+                supported = supported || field.distance[parent] == previous_distance;
+            });
+            if (supported) {
+                return;
+            }
+            pending.emplace_back(next, field.distance[next]);
+            orphaned.push_back(next);
+            field.distance[next] = kUnreachable;
+        });
+    }
+
+    // Re-seed the orphaned region from its settled border and let the
+    // smallest distances flow inward first.
+    std::vector<std::pair<std::uint32_t, CellId>> seeds;
+    for (const auto orphan : orphaned) {
+        std::uint32_t best = kUnreachable;
+        for_each_neighbor(orphan, [&](CellId next) {
+            if (field.distance[next] != kUnreachable) {
+                best = std::min(best, field.distance[next] + 1);
+            }
+        });
+        if (best != kUnreachable) {
+            seeds.emplace_back(best, orphan);
+        }
+    }
+    std::sort(seeds.begin(), seeds.end());
+
+    std::vector<CellId> frontier;
+    std::size_t head = 0;
+    std::size_t next_seed = 0;
+    while (head < frontier.size() || next_seed < seeds.size()) {
+        CellId current = 0;
+        if (next_seed < seeds.size()
+            && (head == frontier.size() || seeds[next_seed].first <= field.distance[frontier[head]])) {
+            const auto [distance, seed] = seeds[next_seed++];
+            if (field.distance[seed] <= distance) {
+                continue;
+            }
+            field.distance[seed] = distance;
+            current = seed;
+        } else {
+            current = frontier[head++];
+        }
+        const std::uint32_t next_distance = field.distance[current] + 1;
+        for_each_neighbor(current, [&](CellId next) {
+            if (field.distance[next] <= next_distance) {
+                return;
+            }
+            const GridPosition position{next % map_->width(), next / map_->width()};
+            if (!map_->is_walkable(position, ignore_towers)) {
+                return;
+            }
+            field.distance[next] = next_distance;
+            frontier.push_back(next);
+        });
+    }
+}
+
+void FlowField::repair_opened(Field& field, CellId cell, bool ignore_towers) const {
+    std::uint32_t best = kUnreachable;
+    for_each_neighbor(cell, [&](CellId next) {
+        if (field.distance[next] != kUnreachable) {
+            best = std::min(best, field.distance[next] + 1);
+        }
+    });
+    if (best == kUnreachable) {
+        return;
+    }
+    field.distance[cell] = best;
+    std::vector<CellId> frontier{cell};
+    propagate(field, frontier, ignore_towers);
+}
+
+void FlowField::propagate(Field& field, std::vector<CellId>& frontier, bool ignore_towers) const {
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+        const CellId current = frontier[head];
+        const std::uint32_t next_distance = field.distance[current] + 1;
+        for_each_neighbor(current, [&](CellId next) {
+            if (field.distance[next] <= next_distance) {
+                return;
+            }
+            const GridPosition position{next % map_->width(), next / map_->width()};
+            if (!map_->is_walkable(position, ignore_towers)) {
+                return;
+            }
+            field.distance[next] = next_distance;
+            frontier.push_back(next);
+        });
+    }
+}
+
+template <typename Visitor>
+void FlowField::for_each_neighbor(CellId cell, Visitor&& visit) const {
+    const std::size_t width = map_->width();
+    const std::size_t height = map_->height();
+    const std::size_t x = cell % width;
+    const std::size_t y = cell / width;
+    for (const auto& [dx, dy] : directions) {
+        const int next_x = static_cast<int>(x) + dx;
+        const int next_y = static_cast<int>(y) + dy;
+        if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(width) || next_y >= static_cast<int>(height)) {
+            continue;
+        }
+        visit(static_cast<CellId>(static_cast<std::size_t>(next_y) * width + static_cast<std::size_t>(next_x)));
+    }
+}
+
+void FlowField::trace(const Field& field, const GridPosition& start, Path& path) const {
+    const std::size_t width = map_->width();
+    const std::size_t height = map_->height();
+    std::uint32_t remaining = field.distance[to_cell_id(start, width)];
+
+    // Every step lowers the distance by one, so no path is longer than the
+    // map has cells, whatever the field claims.
+    path.clear();
+    path.reserve(std::min<std::size_t>(remaining, width * height) + 1);
+    GridPosition current = start;
+    path.push_back(current);
+    while (remaining > 0) {
+        bool stepped = false;
+        for (const auto& [dx, dy] : directions) {
+            const int next_x = static_cast<int>(current.x) + dx;
+            const int next_y = static_cast<int>(current.y) + dy;
+            if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(width) || next_y >= static_cast<int>(height)) {
+                continue;
+            }
+            const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
+            if (field.distance[to_cell_id(next, width)] == remaining - 1) {
+                current = next;
+                stepped = true;
+                break;
+            }
+        }
+        if (!stepped) {
+            break;
+        }
+        path.push_back(current);
+        --remaining;
+    }
+}
+
+RouteHandle FlowField::follow(Field& field, const GridPosition& start) const {
+    const auto start_index = map_->cell_id(start);
+    if (const auto pooled = field.routes.find(start_index); pooled != field.routes.end()) {
+        return pooled->second;
+    }
+    Path path;
+    trace(field, start, path);
+    auto route = Route::from_positions(path);
+    field.routes.emplace(start_index, route);
+    return route;
+}
+
+} // namespace towerdefense
@@ -1,9 +1,11 @@
 #include "towerdefense/Game.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -13,16 +15,43 @@
 namespace towerdefense {
 
 namespace {
-std::unordered_map<GridPosition, char, GridPositionHash> build_entity_symbols(
-    const std::vector<Creature>& creatures, const std::vector<TowerPtr>& towers) {
-    std::unordered_map<GridPosition, char, GridPositionHash> symbols;
-    for (const auto& creature : creatures) {
-        if (creature.is_alive()) {
-            symbols[creature.position()] = creature.is_carrying_resource() ? 'L' : 'C';
+BlueprintHandle make_ambient_blueprint(const char* id, const char* name, int health, double speed, Materials reward,
+    int armor, int shield, bool flying) {
+    auto blueprint = std::make_shared<CreatureBlueprint>();
+    blueprint->id = id;
+    blueprint->name = name;
+    blueprint->max_health = health;
+    blueprint->speed = speed;
+    blueprint->reward = reward;
+    blueprint->armor = armor;
+    blueprint->shield = shield;
+    blueprint->flying = flying;
+    return blueprint;
+}
+
+// Built once; ambient spawns only copy a handle.
+const std::array<BlueprintHandle, 5>& ambient_blueprints() {
+    static const std::array<BlueprintHandle, 5> pool{
+        make_ambient_blueprint("goblin", "Goblin Scout", 6, 0.9, Materials{1, 0, 0}, 0, 0, false),
+        make_ambient_blueprint("brute", "Orc Brute", 16, 0.6, Materials{0, 1, 0}, 2, 0, false),
+        make_ambient_blueprint("burrower", "Burrower", 8, 0.7, Materials{0, 1, 0}, 0, 0, false),
+        make_ambient_blueprint("destroyer", "Destroyer", 18, 0.65, Materials{0, 1, 1}, 1, 2, false),
+        make_ambient_blueprint("wyvern", "Wyvern", 14, 1.0, Materials{0, 0, 1}, 0, 3, true),
+    };
+    return pool;
+}
+
+std::unordered_map<CellId, char> build_entity_symbols(
+    const Map& map, const CreatureStore& creatures, const TowerStore& towers) {
+    std::unordered_map<CellId, char> symbols;
+    symbols.reserve(creatures.size() + towers.size());
+    for (std::size_t i = 0; i < creatures.slot_count(); ++i) {
+        if (creatures.is_alive(i) && map.is_within_bounds(creatures.position(i))) {
+            symbols[map.cell_id(creatures.position(i))] = creatures.is_carrying_resource(i) ? 'L' : 'C';
         }
     }
     for (const auto& tower : towers) {
-        symbols[tower->position()] = 'T';
+        symbols[map.cell_id(tower.position())] = 'T';
     }
     return symbols;
 }
@@ -52,11 +81,18 @@ Game::Game(Map map, Materials starting_materials, int resource_units, GameOption
     , resource_manager_(std::move(starting_materials), Materials{1, 0, 0}, 150)
     , resource_units_(resource_units)
     , max_resource_units_(resource_units)
+    , creature_grid_(map_.width(), map_.height())
     , options_(std::move(options))
+    , flow_field_(map_)
     , path_finder_(map_) {
     if (resource_units <= 0) {
         throw std::invalid_argument("Resource units must be positive");
     }
+    tower_slots_.assign(map_.cell_count(), kNoTower);
+    original_tiles_.assign(map_.cell_count(), TileType::Empty);
+    if (const auto* fields = map_.distance_fields()) {
+        flow_field_.preload(fields->to_resource, fields->to_exit);
+    }
     std::random_device rd;
     ambient_rng_.seed(rd());
     ambient_min_ticks_ = 40;
@@ -85,12 +121,15 @@ void Game::place_tower(const std::string& type, const GridPosition& position) {
     resource_manager_.spend(tower_cost, "Build " + type, static_cast<int>(wave_index_));
 
     auto tower = TowerFactory::create(type, position);
-    tile_restore_[position] = map_.at(position);
+    const auto cell = map_.cell_id(position);
+    original_tiles_[cell] = map_.at(position);
     map_.set(position, TileType::Tower);
-    towers_.push_back(std::move(tower));
-    path_finder_.invalidate_cache();
+    tower_slots_[cell] = towers_.insert(std::move(tower)).index;
+    flow_field_.update_cell(position);
+    path_finder_.update_cell(position);
     path_dirty_ = true;
     ++map_version_;
+    refresh_tower_coverage();
 }
 
 bool Game::can_place_tower(const std::string& type, const GridPosition& position, std::string* reason) const {
@@ -103,9 +142,8 @@ bool Game::can_place_tower(const std::string& type, const GridPosition& position
         set_reason("Cannot place tower outside map bounds");
         return false;
     }
-    const auto tile = map_.at(position);
-    const bool buildable_on_path = options_.maze_mode && tile == TileType::Path;
-    if (tile != TileType::Empty && !buildable_on_path) {
+    const bool buildable_on_path = options_.maze_mode && map_.at(position) == TileType::Path;
+    if (!map_.is_buildable(position) && !buildable_on_path) {
         set_reason("Towers can only be placed on empty tiles");
         return false;
     }
@@ -125,11 +163,10 @@ bool Game::can_place_tower(const std::string& type, const GridPosition& position
 }
 
 void Game::upgrade_tower(const GridPosition& position) {
-    auto index = tower_index(position);
-    if (!index) {
+    auto* tower = tower_at(position);
+    if (!tower) {
         throw std::runtime_error("No tower at the specified position to upgrade");
     }
-    auto& tower = towers_.at(*index);
     if (!tower->next_level()) {
         throw std::runtime_error("Tower is already at maximum level");
     }
@@ -139,27 +176,19 @@ void Game::upgrade_tower(const GridPosition& position) {
         throw std::runtime_error("Insufficient materials for upgrade");
     }
     tower->upgrade();
+    refresh_tower_coverage();
 }
 
 Materials Game::sell_tower(const GridPosition& position) {
-    auto index = tower_index(position);
-    if (!index) {
+    const auto handle = tower_handle(position);
+    if (!handle) {
         throw std::runtime_error("No tower at the specified position to sell");
     }
-    auto& tower = towers_.at(*index);
+    const auto* tower = towers_.find(*handle);
     const auto refund = tower->sell_value();
     const std::string description = "Sell " + tower->name();
     resource_manager_.refund(refund, description, static_cast<int>(wave_index_));
-    if (auto original = tile_restore_.find(position); original != tile_restore_.end()) {
-        map_.set(position, original->second);
-        tile_restore_.erase(original);
-    } else {
-        map_.set(position, TileType::Empty);
-    }
-    towers_.erase(towers_.begin() + static_cast<std::ptrdiff_t>(*index));
-    path_finder_.invalidate_cache();
-    path_dirty_ = true;
-    ++map_version_;
+    remove_tower(*handle, position);
     return refund;
 }
 
@@ -205,14 +234,13 @@ void Game::spawn_creatures() {
         }
         const auto& entry = map_.entries()[entry_spawn_index_ % map_.entries().size()];
         entry_spawn_index_ = (entry_spawn_index_ + 1) % map_.entries().size();
-        const bool can_tunnel = creature_has_behavior(creature, "burrower") || creature_has_behavior(creature, "destroyer");
-        if (auto path = compute_path(entry, map_.resource_position(), can_tunnel)) {
-            creature.assign_path(*path);
-            creatures_.push_back(std::move(creature));
+        const bool can_tunnel = creature.has_behavior(BehaviorRegistry::kBurrower | BehaviorRegistry::kDestroyer);
+        if (auto route = resource_path(entry, can_tunnel)) {
+            creature.assign_path(std::move(route));
         } else {
-            creature.assign_path({entry, map_.resource_position()});
-            creatures_.push_back(std::move(creature));
+            creature.assign_path(Route::from_positions({entry, map_.resource_position()}));
         }
+        creatures_.push(std::move(creature));
     }
 
     if (wave.is_empty()) {
@@ -249,27 +277,11 @@ void Game::spawn_ambient_creatures() {
         return;
     }
 
-    const struct {
-        const char* id;
-        const char* name;
-        int hp;
-        double speed;
-        Materials reward;
-        int armor;
-        int shield;
-        bool flying;
-    } ambient_pool[] = {
-        {"goblin", "Goblin Scout", 6, 0.9, Materials{1, 0, 0}, 0, 0, false},
-        {"brute", "Orc Brute", 16, 0.6, Materials{0, 1, 0}, 2, 0, false},
-        {"burrower", "Burrower", 8, 0.7, Materials{0, 1, 0}, 0, 0, false},
-        {"destroyer", "Destroyer", 18, 0.65, Materials{0, 1, 1}, 1, 2, false},
-        {"wyvern", "Wyvern", 14, 1.0, Materials{0, 0, 1}, 0, 3, true},
-    };
-    std::uniform_int_distribution<std::size_t> pick(0, std::size(ambient_pool) - 1);
+    const auto& pool = ambient_blueprints();
+    std::uniform_int_distribution<std::size_t> pick(0, pool.size() - 1);
     const std::size_t spawn_count = std::uniform_int_distribution<std::size_t>(10, 20)(ambient_rng_);
     for (std::size_t i = 0; i < spawn_count; ++i) {
-        const auto& chosen = ambient_pool[pick(ambient_rng_)];
-        Creature creature{chosen.id, chosen.name, chosen.hp, chosen.speed, chosen.reward, chosen.armor, chosen.shield, chosen.flying};
+        Creature creature{pool[pick(ambient_rng_)]};
         const double hp_scale = 1.5 + 0.25 * static_cast<double>(wave_index_);
         creature.scale_health(hp_scale);
         creature.scale_speed(0.5);
@@ -278,37 +290,37 @@ void Game::spawn_ambient_creatures() {
         creature.apply_slow(0.75, 1); // nudge ambient speeds even lower
         const auto& entry = map_.entries()[entry_spawn_index_ % map_.entries().size()];
         entry_spawn_index_ = (entry_spawn_index_ + 1) % map_.entries().size();
-        const bool can_tunnel = creature_has_behavior(creature, "burrower") || creature_has_behavior(creature, "destroyer");
-        if (auto path = compute_path(entry, map_.resource_position(), can_tunnel)) {
-            creature.assign_path(*path);
-            creatures_.push_back(creature);
+        const bool can_tunnel = creature.has_behavior(BehaviorRegistry::kBurrower | BehaviorRegistry::kDestroyer);
+        if (auto route = resource_path(entry, can_tunnel)) {
+            creature.assign_path(std::move(route));
+            creatures_.push(std::move(creature));
         }
     }
 }
 
 void Game::move_creatures() {
-    for (auto& creature : creatures_) {
-        if (!creature.is_alive()) {
+    creatures_.advance_all();
+    for (std::size_t i = 0; i < creatures_.slot_count(); ++i) {
+        if (!creatures_.is_alive(i)) {
             continue;
         }
-        creature.tick();
-        const auto current_pos = creature.position();
+        const auto current_pos = creatures_.position(i);
 
-        if (creature_has_behavior(creature, "destroyer")) {
+        if (creatures_.has_behavior(i, BehaviorRegistry::kDestroyer)) {
             if (find_tower(current_pos)) {
-                destroy_tower(current_pos, creature.name());
+                destroy_tower(current_pos, creatures_.name(i));
             }
         }
 
-        if (!creature.is_carrying_resource() && current_pos == map_.resource_position()) {
-            handle_goal(creature);
-        } else if (creature.is_carrying_resource()) {
+        if (!creatures_.is_carrying_resource(i) && current_pos == map_.resource_position()) {
+            handle_goal(i);
+        } else if (creatures_.is_carrying_resource(i)) {
             if (map_.exits().empty()) {
-                creature.apply_damage(std::numeric_limits<int>::max() / 4); // force HP to 0 via damage
+                creatures_.apply_damage(i, std::numeric_limits<int>::max() / 4); // force HP to 0 via damage
             } else {
                 for (const auto& exit : map_.exits()) {
                     if (current_pos == exit) {
-                        creature.apply_damage(std::numeric_limits<int>::max() / 4); // remove on exit via HP
+                        creatures_.apply_damage(i, std::numeric_limits<int>::max() / 4); // remove on exit via HP
                         break;
                     }
                 }
@@ -318,160 +330,110 @@ void Game::move_creatures() {
 }
 
 void Game::towers_attack() {
-    for (auto& tower : towers_) {
-        tower->tick();
-        if (!tower->can_attack()) {
-            continue;
-        }
-        if (tower->attack(creatures_)) {
-            tower->reset_cooldown();
-        }
-    }
+    refresh_tower_coverage();
+    creature_grid_.rebuild(creatures_, map_);
+    towers_.attack_all(creatures_, creature_grid_);
+}
+
+void Game::refresh_tower_coverage() {
+    towers_.refresh_coverage(map_, map_version_);
 }
 
 void Game::cleanup_creatures() {
-    creatures_.erase(std::remove_if(creatures_.begin(), creatures_.end(), [this](Creature& creature) {
-                          if (!creature.is_alive()) {
-                              resource_manager_.income(creature.reward(),
-                                  "Defeated " + creature.name(), static_cast<int>(wave_index_));
-                              return true;
-                          }
-                          return false;
-                      }),
-        creatures_.end());
+    creatures_.remove_dead([this](std::size_t index) {
+        resource_manager_.income(
+            creatures_.reward(index), "Defeated " + creatures_.name(index), static_cast<int>(wave_index_));
+    });
 }
 
-void Game::handle_goal(Creature& creature) {
-    creature.mark_goal_reached();
+void Game::handle_goal(std::size_t creature) {
+    creatures_.mark_goal_reached(creature);
     if (resource_units_ > 0) {
-        const int damage = std::max(1, creature.leak_damage());
+        const int damage = std::max(1, creatures_.leak_damage(creature));
         resource_units_ = std::max(0, resource_units_ - damage);
     }
     breach_since_last_income_ = true;
-    const auto& steal = creature.steal_amount();
+    const auto& steal = creatures_.steal_amount(creature);
     if (steal.wood() > 0 || steal.stone() > 0 || steal.crystal() > 0) {
-        resource_manager_.steal(steal, creature.name() + " theft", static_cast<int>(wave_index_));
+        resource_manager_.steal(steal, creatures_.name(creature) + " theft", static_cast<int>(wave_index_));
     }
 
     // Remove only via health reaching zero.
-    creature.apply_damage(std::numeric_limits<int>::max() / 4);
+    creatures_.apply_damage(creature, std::numeric_limits<int>::max() / 4);
 }
 
 void Game::recalculate_creature_paths() {
-    for (auto& creature : creatures_) {
-        if (!creature.is_alive()) {
+    route_requests_.clear();
+    route_owners_.clear();
+    for (std::size_t i = 0; i < creatures_.slot_count(); ++i) {
+        if (!creatures_.is_alive(i)) {
             continue;
         }
-        const bool returning = creature.is_carrying_resource();
-        std::optional<std::vector<GridPosition>> path;
-        const auto start = creature.position();
-        const bool can_tunnel = creature_has_behavior(creature, "burrower") || creature_has_behavior(creature, "destroyer");
-        if (returning) {
-            path = best_exit_path(start, can_tunnel);
-        } else {
-            path = compute_path(start, map_.resource_position(), can_tunnel);
+        const bool can_tunnel = creatures_.has_behavior(i, BehaviorRegistry::kBurrower | BehaviorRegistry::kDestroyer);
+        route_requests_.push_back(FlowField::RouteRequest{creatures_.position(i), creatures_.is_carrying_resource(i), can_tunnel});
+        route_owners_.push_back(i);
+    }
+    route_results_.resize(route_requests_.size());
+    flow_field_.route_batch(route_requests_, route_results_, path_workers_);
+
+    // Write back in creature order so the outcome never depends on which
+    // worker traced a route.
+    for (std::size_t i = 0; i < route_owners_.size(); ++i) {
+        auto& route = route_results_[i];
+        if (!route) {
+            continue;
         }
-        if (path) {
-            if (returning) {
-                creature.start_returning(*path);
-            } else {
-                creature.assign_path(*path);
-            }
+        if (route_requests_[i].to_nearest_exit) {
+            creatures_.start_returning(route_owners_[i], std::move(route));
+        } else {
+            creatures_.assign_path(route_owners_[i], std::move(route));
         }
     }
 }
 
-std::optional<std::vector<GridPosition>> Game::compute_path(
-    const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze) {
-    if (auto path = path_finder_.shortest_path(start, goal, allow_tower_squeeze)) {
-        return path;
-    }
-    return std::nullopt;
-}
-
-std::optional<std::vector<GridPosition>> Game::best_exit_path(const GridPosition& from, bool allow_tower_squeeze) {
-    if (map_.exits().empty()) {
-        return std::nullopt;
-    }
-
-    std::optional<std::vector<GridPosition>> best;
-    for (const auto& exit : map_.exits()) {
-        if (auto path = compute_path(from, exit, allow_tower_squeeze)) {
-            if (!best || path->size() < best->size()) {
-                best = std::move(path);
-            }
-        }
-    }
-    return best;
+RouteHandle Game::resource_path(const GridPosition& from, bool allow_tower_squeeze) {
+    return flow_field_.route_to_resource(from, allow_tower_squeeze);
 }
 
 std::optional<std::vector<GridPosition>> Game::current_entry_path() const {
-    PathFinder finder(map_);
     for (const auto& entry : map_.entries()) {
-        if (auto path = finder.shortest_path(entry, map_.resource_position(), false)) {
+        if (auto path = path_finder_.shortest_path(entry, map_.resource_position(), false)) {
             return path;
         }
     }
     return std::nullopt;
 }
 
-bool Game::path_exists_via_entries(const Map& map) const {
-    if (map.entries().empty()) {
-        return false;
-    }
-    PathFinder finder(map);
-    bool entry_reachable = false;
-    for (const auto& entry : map.entries()) {
-        if (finder.shortest_path(entry, map.resource_position(), false)) {
-            entry_reachable = true;
-            break;
-        }
-    }
-    if (!entry_reachable) {
-        return false;
-    }
-    if (map.exits().empty()) {
-        return true;
-    }
-    for (const auto& exit : map.exits()) {
-        if (finder.shortest_path(map.resource_position(), exit, false)) {
-            return true;
-        }
-    }
-    return false;
-}
-
 bool Game::would_block_paths(const GridPosition& position) const {
     if (!map_.is_within_bounds(position)) {
         return true;
     }
-    Map hypothetical = map_;
-    hypothetical.set(position, TileType::Tower);
-    return !path_exists_via_entries(hypothetical);
-}
-
-bool Game::creature_has_behavior(const Creature& creature, std::string_view behavior) const {
-    const auto& behaviors = creature.behaviors();
-    return std::find(behaviors.begin(), behaviors.end(), behavior) != behaviors.end();
+    if (connectivity_version_ != map_version_) {
+        connectivity_.rebuild(map_);
+        connectivity_version_ = map_version_;
+    }
+    return connectivity_.would_disconnect(position);
 }
 
 void Game::destroy_tower(const GridPosition& position, const std::string& /*source*/) {
-    if (auto index = tower_index(position)) {
-        if (auto original = tile_restore_.find(position); original != tile_restore_.end()) {
-            map_.set(position, original->second);
-            tile_restore_.erase(original);
-        } else {
-            map_.set(position, TileType::Empty);
-        }
-        towers_.erase(towers_.begin() + static_cast<std::ptrdiff_t>(*index));
-        path_finder_.invalidate_cache();
-        path_dirty_ = true;
-        ++map_version_;
+    if (auto handle = tower_handle(position)) {
+        remove_tower(*handle, position);
     }
 }
 
+void Game::remove_tower(TowerHandle handle, const GridPosition& position) {
+    const auto cell = map_.cell_id(position);
+    map_.set(position, original_tiles_[cell]);
+    tower_slots_[cell] = kNoTower;
+    towers_.erase(handle);
+    flow_field_.update_cell(position);
+    path_finder_.update_cell(position);
+    path_dirty_ = true;
+    ++map_version_;
+}
+
 void Game::render(std::ostream& os) const {
-    const auto symbols = build_entity_symbols(creatures_, towers_);
+    const auto symbols = build_entity_symbols(map_, creatures_, towers_);
     const auto lines = map_.render_with_entities(symbols);
     os << "Resources remaining: " << resource_units_ << '\n';
     os << "Materials: " << resource_manager_.materials().to_string() << '\n';
@@ -496,26 +458,28 @@ void Game::render(std::ostream& os) const {
 }
 
 Tower* Game::tower_at(const GridPosition& position) {
-    if (auto index = tower_index(position)) {
-        return towers_[*index].get();
+    if (auto handle = tower_handle(position)) {
+        return towers_.find(*handle);
     }
     return nullptr;
 }
 
 const Tower* Game::tower_at(const GridPosition& position) const {
-    if (auto index = tower_index(position)) {
-        return towers_[*index].get();
+    if (auto handle = tower_handle(position)) {
+        return towers_.find(*handle);
     }
     return nullptr;
 }
 
-std::optional<std::size_t> Game::tower_index(const GridPosition& position) const {
-    for (std::size_t i = 0; i < towers_.size(); ++i) {
-        if (towers_[i] && towers_[i]->position() == position) {
-            return i;
-        }
+std::optional<TowerHandle> Game::tower_handle(const GridPosition& position) const {
+    if (!map_.is_within_bounds(position)) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    const auto slot = tower_slots_[map_.cell_id(position)];
+    if (slot == kNoTower) {
+        return std::nullopt;
+    }
+    return towers_.handle(slot);
 }
 
 Tower* Game::find_tower(const GridPosition& position) {
@@ -0,0 +1,367 @@
+#include "towerdefense/HierarchicalPathFinder.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace towerdefense {
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+
+// Border runs at least this long get a transition at each end instead of
+// one in the middle, which keeps detours along wide openings short.
+constexpr std::size_t kLongEntrance = 6;
+
+constexpr std::uint32_t kStartNode = 0xFFFFFFFFu;
+constexpr std::uint32_t kGoalNode = 0xFFFFFFFEu;
+}
+
+HierarchicalPathFinder::HierarchicalPathFinder(const Map& map, std::size_t cluster_size)
+    : map_(&map)
+    , cluster_size_(cluster_size) {
+    if (cluster_size_ == 0) {
+        throw std::invalid_argument("Cluster size must be positive");
+    }
+    clusters_x_ = (map.width() + cluster_size_ - 1) / cluster_size_;
+    clusters_y_ = (map.height() + cluster_size_ - 1) / cluster_size_;
+}
+
+std::optional<std::vector<GridPosition>> HierarchicalPathFinder::find_path(
+    const GridPosition& start, const GridPosition& goal, bool ignore_towers) {
+    if (!map_->is_walkable(start, ignore_towers) || !map_->is_walkable(goal, ignore_towers)) {
+        return std::nullopt;
+    }
+    if (start == goal) {
+        return Path{start};
+    }
+
+    auto& layer = layers_[ignore_towers ? 1 : 0];
+    refresh(layer, ignore_towers);
+
+    const std::size_t width = map_->width();
+    const auto start_cell = to_cell_id(start, width);
+    const auto goal_cell = to_cell_id(goal, width);
+    const std::size_t start_cluster = cluster_of(start_cell);
+    const std::size_t goal_cluster = cluster_of(goal_cell);
+
+    // Connect start and goal to the transitions of their own clusters.
+    const auto& goal_nodes = layer.clusters[goal_cluster].nodes;
+    search_cluster(goal_cluster, goal_cell, ignore_towers);
+    std::vector<std::uint32_t> goal_costs(goal_nodes.size());
+    for (std::size_t j = 0; j < goal_nodes.size(); ++j) {
+        goal_costs[j] = local_distance_[local_index(goal_cluster, goal_nodes[j])];
+    }
+    const auto& start_nodes = layer.clusters[start_cluster].nodes;
+    search_cluster(start_cluster, start_cell, ignore_towers);
+    const std::uint32_t direct
+        = start_cluster == goal_cluster ? local_distance_[local_index(start_cluster, goal_cell)] : kUnreachable;
+
+    using Item = std::pair<std::uint32_t, std::uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> open;
+    search_.clear();
+    auto estimate = [&](std::uint32_t cell) -> std::uint32_t {
+        if (cell == kGoalNode) {
+            return 0;
+        }
+        const std::size_t x = cell % width;
+        const std::size_t y = cell / width;
+        const std::size_t dx = x > goal.x ? x - goal.x : goal.x - x;
+        const std::size_t dy = y > goal.y ? y - goal.y : goal.y - y;
+        return static_cast<std::uint32_t>(dx + dy);
+    };
+    auto relax = [&](std::uint32_t cell, std::uint32_t cost, std::uint32_t parent) {
+        auto& entry = search_.try_emplace(cell, SearchEntry{kUnreachable, 0, false}).first->second;
+        if (entry.closed || cost >= entry.cost) {
+            return;
+        }
+        entry.cost = cost;
+        entry.parent = parent;
+        open.emplace(cost + estimate(cell), cell);
+    };
+
+    for (std::size_t j = 0; j < start_nodes.size(); ++j) {
+        const std::uint32_t cost = local_distance_[local_index(start_cluster, start_nodes[j])];
+        if (cost != kUnreachable) {
+            relax(start_nodes[j], cost, kStartNode);
+        }
+    }
+    if (direct != kUnreachable) {
+        relax(kGoalNode, direct, kStartNode);
+    }
+
+    bool found = false;
+    while (!open.empty()) {
+        const std::uint32_t cell = open.top().second;
+        open.pop();
+        auto& entry = search_[cell];
+        if (entry.closed) {
+            continue;
+        }
+        entry.closed = true;
+        if (cell == kGoalNode) {
+            found = true;
+            break;
+        }
+        const std::uint32_t cost = entry.cost;
+        const std::size_t cluster_index = cluster_of(cell);
+        const auto& cluster = layer.clusters[cluster_index];
+        const std::size_t count = cluster.nodes.size();
+        const auto i = static_cast<std::size_t>(
+            std::lower_bound(cluster.nodes.begin(), cluster.nodes.end(), cell) - cluster.nodes.begin());
+        for (std::size_t j = 0; j < count; ++j) {
+            const std::uint32_t step = cluster.distance[i * count + j];
+            if (j != i && step != kUnreachable) {
+                relax(cluster.nodes[j], cost + step, cell);
+            }
+        }
+        const std::size_t x = cell % width;
+        const std::size_t y = cell / width;
+        for (const auto& [dx, dy] : directions) {
+            const int next_x = static_cast<int>(x) + dx;
+            const int next_y = static_cast<int>(y) + dy;
+            if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(width)
+                || next_y >= static_cast<int>(map_->height())) {
+                continue;
+            }
+            const auto next = static_cast<std::uint32_t>(static_cast<std::size_t>(next_y) * width + static_cast<std::size_t>(next_x));
+            const std::size_t next_cluster = cluster_of(next);
+            if (next_cluster == cluster_index) {
+                continue;
+            }
+            const auto& neighbours = layer.clusters[next_cluster].nodes;
+            if (std::binary_search(neighbours.begin(), neighbours.end(), next)) {
+                relax(next, cost + 1, cell);
+            }
+        }
+        if (cluster_index == goal_cluster && goal_costs[i] != kUnreachable) {
+            relax(kGoalNode, cost + goal_costs[i], cell);
+        }
+    }
+    if (!found) {
+        return std::nullopt;
+    }
+
+    // Abstract hops, then refine each hop into cells.
+    std::vector<std::uint32_t> hops{goal_cell};
+    for (std::uint32_t node = search_[kGoalNode].parent; node != kStartNode; node = search_[node].parent) {
+        hops.push_back(node);
+    }
+    hops.push_back(start_cell);
+    std::reverse(hops.begin(), hops.end());
+
+    Path path{start};
+    for (std::size_t h = 1; h < hops.size(); ++h) {
+        const std::uint32_t from = hops[h - 1];
+        const std::uint32_t to = hops[h];
+        if (from == to) {
+            continue;
+        }
+        if (cluster_of(from) != cluster_of(to)) {
+            path.push_back(GridPosition{to % width, to / width});
+        } else {
+            append_segment(path, from, to, ignore_towers);
+        }
+    }
+    return path;
+}
+
+void HierarchicalPathFinder::update_cell(const GridPosition& position) {
+    if (!map_->is_within_bounds(position)) {
+        return;
+    }
+    const std::size_t cluster_x = position.x / cluster_size_;
+    const std::size_t cluster_y = position.y / cluster_size_;
+    mark_dirty(cluster_x, cluster_y);
+    // Border cells also shape the transitions of the cluster across the border.
+    if (position.x % cluster_size_ == 0 && cluster_x > 0) {
+        mark_dirty(cluster_x - 1, cluster_y);
+    }
+    if (position.x % cluster_size_ == cluster_size_ - 1 && cluster_x + 1 < clusters_x_) {
+        mark_dirty(cluster_x + 1, cluster_y);
+    }
+    if (position.y % cluster_size_ == 0 && cluster_y > 0) {
+        mark_dirty(cluster_x, cluster_y - 1);
+    }
+    if (position.y % cluster_size_ == cluster_size_ - 1 && cluster_y + 1 < clusters_y_) {
+        mark_dirty(cluster_x, cluster_y + 1);
+    }
+}
+
+void HierarchicalPathFinder::invalidate() {
+    for (auto& layer : layers_) {
+        layer.built = false;
+    }
+}
+
+std::size_t HierarchicalPathFinder::cluster_of(std::uint32_t cell) const noexcept {
+    const std::size_t width = map_->width();
+    return (cell / width / cluster_size_) * clusters_x_ + (cell % width) / cluster_size_;
+}
+
+HierarchicalPathFinder::Bounds HierarchicalPathFinder::bounds(std::size_t cluster) const noexcept {
+    Bounds result;
+    result.x0 = (cluster % clusters_x_) * cluster_size_;
+    result.y0 = (cluster / clusters_x_) * cluster_size_;
+    result.width = std::min(cluster_size_, map_->width() - result.x0);
+    result.height = std::min(cluster_size_, map_->height() - result.y0);
+    return result;
+}
+
+bool HierarchicalPathFinder::walkable(std::size_t x, std::size_t y, bool ignore_towers) const noexcept {
+    return map_->is_walkable(GridPosition{x, y}, ignore_towers);
+}
+
+void HierarchicalPathFinder::mark_dirty(std::size_t cluster_x, std::size_t cluster_y) {
+    for (auto& layer : layers_) {
+        if (layer.built) {
+            layer.clusters[cluster_y * clusters_x_ + cluster_x].dirty = true;
+        }
+    }
+}
+
+void HierarchicalPathFinder::refresh(Layer& layer, bool ignore_towers) {
+    if (!layer.built) {
+        layer.clusters.assign(clusters_x_ * clusters_y_, Cluster{});
+        layer.built = true;
+    }
+    for (std::size_t index = 0; index < layer.clusters.size(); ++index) {
+        if (layer.clusters[index].dirty) {
+            rebuild_cluster(layer.clusters[index], index, ignore_towers);
+        }
+    }
+}
+
+void HierarchicalPathFinder::rebuild_cluster(Cluster& cluster, std::size_t index, bool ignore_towers) {
+    cluster.nodes.clear();
+    add_border_transitions(cluster.nodes, index, ignore_towers);
+    std::sort(cluster.nodes.begin(), cluster.nodes.end());
+    cluster.nodes.erase(std::unique(cluster.nodes.begin(), cluster.nodes.end()), cluster.nodes.end());
+
+    const std::size_t count = cluster.nodes.size();
+    cluster.distance.assign(count * count, kUnreachable);
+    for (std::size_t i = 0; i < count; ++i) {
+        search_cluster(index, cluster.nodes[i], ignore_towers);
+        for (std::size_t j = 0; j < count; ++j) {
+            cluster.distance[i * count + j] = local_distance_[local_index(index, cluster.nodes[j])];
+        }
+    }
+    cluster.dirty = false;
+}
+
+void HierarchicalPathFinder::add_border_transitions(
+    std::vector<std::uint32_t>& nodes, std::size_t index, bool ignore_towers) const {
+    const std::size_t width = map_->width();
+    const auto area = bounds(index);
+    const std::size_t cluster_x = index % clusters_x_;
+    const std::size_t cluster_y = index / clusters_x_;
+
+    // Walks one shared border and keeps this cluster's side of every run of
+    // open cell pairs. Both clusters derive the same positions from the same
+    // cells, so transitions always come in matching pairs.
+    auto scan = [&](std::size_t length, auto&& own_cell, auto&& open_pair) {
+        std::size_t run_start = 0;
+        bool in_run = false;
+        for (std::size_t i = 0; i <= length; ++i) {
+            const bool open = i < length && open_pair(i);
+            if (open && !in_run) {
+                run_start = i;
+                in_run = true;
+            } else if (!open && in_run) {
+                const std::size_t run_end = i - 1;
+                if (run_end - run_start + 1 < kLongEntrance) {
+                    nodes.push_back(own_cell((run_start + run_end) / 2));
+                } else {
+                    nodes.push_back(own_cell(run_start));
+                    nodes.push_back(own_cell(run_end));
+                }
+                in_run = false;
+            }
+        }
+    };
+    auto vertical_border = [&](std::size_t own_x, std::size_t other_x) {
+        scan(
+            area.height,
+            [&](std::size_t i) { return static_cast<std::uint32_t>((area.y0 + i) * width + own_x); },
+            [&](std::size_t i) {
+                return walkable(own_x, area.y0 + i, ignore_towers) && walkable(other_x, area.y0 + i, ignore_towers);
+            });
+    };
+    auto horizontal_border = [&](std::size_t own_y, std::size_t other_y) {
+        scan(
+            area.width,
+            [&](std::size_t i) { return static_cast<std::uint32_t>(own_y * width + area.x0 + i); },
+            [&](std::size_t i) {
+                return walkable(area.x0 + i, own_y, ignore_towers) && walkable(area.x0 + i, other_y, ignore_towers);
+            });
+    };
+
+    if (cluster_x > 0) {
+        vertical_border(area.x0, area.x0 - 1);
+    }
+    if (cluster_x + 1 < clusters_x_) {
+        vertical_border(area.x0 + area.width - 1, area.x0 + area.width);
+    }
+    if (cluster_y > 0) {
+        horizontal_border(area.y0, area.y0 - 1);
+    }
+    if (cluster_y + 1 < clusters_y_) {
+        horizontal_border(area.y0 + area.height - 1, area.y0 + area.height);
+    }
+}
+
+void HierarchicalPathFinder::search_cluster(std::size_t cluster, std::uint32_t source, bool ignore_towers) {
+    const auto area = bounds(cluster);
+    local_distance_.assign(area.width * area.height, kUnreachable);
+    local_parent_.resize(area.width * area.height);
+    local_frontier_.clear();
+
+    const std::uint32_t origin = local_index(cluster, source);
+    local_distance_[origin] = 0;
+    local_parent_[origin] = origin;
+    local_frontier_.push_back(origin);
+    for (std::size_t head = 0; head < local_frontier_.size(); ++head) {
+        const std::uint32_t current = local_frontier_[head];
+        const std::size_t x = current % area.width;
+        const std::size_t y = current / area.width;
+        for (const auto& [dx, dy] : directions) {
+            const int next_x = static_cast<int>(x) + dx;
+            const int next_y = static_cast<int>(y) + dy;
+            if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(area.width)
+                || next_y >= static_cast<int>(area.height)) {
+                continue;
+            }
+            const auto next = static_cast<std::uint32_t>(static_cast<std::size_t>(next_y) * area.width + static_cast<std::size_t>(next_x));
+            if (local_distance_[next] != kUnreachable
+                || !walkable(area.x0 + static_cast<std::size_t>(next_x), area.y0 + static_cast<std::size_t>(next_y), ignore_towers)) {
+                continue;
+            }
+            local_distance_[next] = local_distance_[current] + 1;
+            local_parent_[next] = current;
+            local_frontier_.push_back(next);
+        }
+    }
+}
+
+std::uint32_t HierarchicalPathFinder::local_index(std::size_t cluster, std::uint32_t cell) const noexcept {
+    const auto area = bounds(cluster);
+    const std::size_t width = map_->width();
+    return static_cast<std::uint32_t>((cell / width - area.y0) * area.width + (cell % width - area.x0));
+}
+
+void HierarchicalPathFinder::append_segment(Path& path, std::uint32_t from, std::uint32_t to, bool ignore_towers) {
+    const std::size_t cluster = cluster_of(from);
+    const auto area = bounds(cluster);
+    search_cluster(cluster, from, ignore_towers);
+
+    const std::size_t offset = path.size();
+    const std::uint32_t origin = local_index(cluster, from);
+    for (std::uint32_t current = local_index(cluster, to); current != origin; current = local_parent_[current]) {
+        path.push_back(GridPosition{area.x0 + current % area.width, area.y0 + current / area.width});
+    }
+    std::reverse(path.begin() + static_cast<std::ptrdiff_t>(offset), path.end());
+}
+
+} // namespace towerdefense
@@ -0,0 +1,264 @@
+#include "towerdefense/JumpPointSearch.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace towerdefense {
+
+namespace {
+constexpr std::size_t kWordBits = 64;
+
+std::size_t distance_between(std::size_t a, std::size_t b) noexcept {
+    return a > b ? a - b : b - a;
+}
+
+int step_towards(std::size_t from, std::size_t to) noexcept {
+    return from < to ? 1 : (from > to ? -1 : 0);
+}
+}
+
+JumpPointSearch::JumpPointSearch(const Map& map)
+    : map_(&map) {}
+
+std::optional<std::vector<GridPosition>> JumpPointSearch::find_path(
+    const GridPosition& start, const GridPosition& goal, bool ignore_towers) {
+    if (!map_->is_walkable(start, ignore_towers) || !map_->is_walkable(goal, ignore_towers)) {
+        return std::nullopt;
+    }
+    if (start == goal) {
+        return Path{start};
+    }
+    const Plane plane = map_->plane(ignore_towers ? Map::Plane::WalkableIgnoringTowers : Map::Plane::Walkable);
+
+    prepare_scratch();
+    const std::size_t width = map_->width();
+    const std::uint32_t generation = scratch_.current;
+    auto* stamp = scratch_.generation.data();
+    auto* cost = scratch_.cost.data();
+    auto* parent = scratch_.parent.data();
+
+    auto estimate = [&](std::size_t x, std::size_t y) {
+        return static_cast<std::uint32_t>(distance_between(x, goal.x) + distance_between(y, goal.y));
+    };
+    using Item = std::pair<std::uint32_t, std::uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> open;
+
+    const auto start_cell = to_cell_id(start, width);
+    const auto goal_cell = to_cell_id(goal, width);
+    stamp[start_cell] = generation;
+    cost[start_cell] = 0;
+    parent[start_cell] = start_cell;
+    open.emplace(estimate(start.x, start.y), start_cell);
+
+    auto relax = [&](std::uint32_t from, std::size_t x, std::size_t y) {
+        const auto cell = static_cast<std::uint32_t>(y * width + x);
+        const std::size_t from_x = from % width;
+        const std::size_t from_y = from / width;
+        const auto next_cost
+            = cost[from] + static_cast<std::uint32_t>(distance_between(from_x, x) + distance_between(from_y, y));
+        if (stamp[cell] == generation && cost[cell] <= next_cost) {
+            return;
+        }
+        stamp[cell] = generation;
+        cost[cell] = next_cost;
+        parent[cell] = from;
+        open.emplace(next_cost + estimate(x, y), cell);
+    };
+
+    bool found = false;
+    while (!open.empty()) {
+        const auto [priority, current] = open.top();
+        open.pop();
+        const std::size_t x = current % width;
+        const std::size_t y = current / width;
+        if (priority > cost[current] + estimate(x, y)) {
+            continue;
+        }
+        if (current == goal_cell) {
+            found = true;
+            break;
+        }
+
+        // Successors follow the canonical order: a horizontal run only turns
+        // where the turn is forced, a vertical run may turn anywhere.
+        const std::uint32_t from = parent[current];
+        const int dx = step_towards(from % width, x);
+        const int dy = step_towards(from / width, y);
+        auto try_horizontal = [&](int direction) {
+            if (auto next_x = jump_horizontal(plane, x, y, direction, goal)) {
+                relax(current, *next_x, y);
+            }
+        };
+        auto try_vertical = [&](int direction) {
+            if (auto next_y = jump_vertical(plane, x, y, direction, goal)) {
+                relax(current, x, *next_y);
+            }
+        };
+        if (dx != 0) {
+            try_horizontal(dx);
+            const std::size_t behind = static_cast<std::size_t>(static_cast<int>(x) - dx);
+            for (const int side : {-1, 1}) {
+                if (side < 0 && y == 0) {
+                    continue;
+                }
+                const std::size_t row = static_cast<std::size_t>(static_cast<int>(y) + side);
+                if (is_open(plane, x, row) && !is_open(plane, behind, row)) {
+                    try_vertical(side);
+                }
+            }
+        } else {
+            try_horizontal(1);
+            try_horizontal(-1);
+            if (dy != 0) {
+                try_vertical(dy);
+            } else {
+                try_vertical(1);
+                try_vertical(-1);
+            }
+        }
+    }
+    if (!found) {
+        return std::nullopt;
+    }
+
+    // Jump points are joined by straight runs; expand them back into cells.
+    Path path;
+    path.reserve(cost[goal_cell] + 1);
+    path.push_back(goal);
+    for (std::uint32_t current = goal_cell; current != start_cell; current = parent[current]) {
+        const std::uint32_t from = parent[current];
+        std::size_t x = current % width;
+        std::size_t y = current / width;
+        const int dx = step_towards(x, from % width);
+        const int dy = step_towards(y, from / width);
+        while (x != from % width || y != from / width) {
+            x = static_cast<std::size_t>(static_cast<int>(x) + dx);
+            y = static_cast<std::size_t>(static_cast<int>(y) + dy);
+            path.push_back(GridPosition{x, y});
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool JumpPointSearch::is_open(const Plane& plane, std::size_t x, std::size_t y) const noexcept {
+    if (x >= map_->width() || y >= map_->height()) {
+        return false;
+    }
+    return (plane[y * map_->words_per_row() + x / kWordBits] >> (x % kWordBits)) & 1U;
+}
+
+std::optional<std::size_t> JumpPointSearch::jump_horizontal(
+    const Plane& plane, std::size_t x, std::size_t y, int dx, const GridPosition& goal) const noexcept {
+    const std::size_t width = map_->width();
+    const std::size_t height = map_->height();
+    const std::size_t words_per_row = map_->words_per_row();
+    const std::uint64_t* row = plane.data() + y * words_per_row;
+    const std::uint64_t* above = y > 0 ? row - words_per_row : nullptr;
+    const std::uint64_t* below = y + 1 < height ? row + words_per_row : nullptr;
+    auto word = [&](const std::uint64_t* line, std::size_t index) -> std::uint64_t {
+        return line != nullptr && index < words_per_row ? line[index] : 0;
+    };
+    const std::size_t goal_word = goal.y == y ? goal.x / kWordBits : words_per_row;
+    const std::uint64_t goal_bit = std::uint64_t{1} << (goal.x % kWordBits);
+
+    // A cell stops the run when it is blocked, is the goal, or has a side
+    // neighbour that is open while the one behind it is not (a forced turn).
+    auto stops = [&](std::size_t index, std::uint64_t above_behind, std::uint64_t below_behind) {
+        const std::uint64_t up = word(above, index);
+        const std::uint64_t down = word(below, index);
+        std::uint64_t result = ~row[index] | (up & ~above_behind) | (down & ~below_behind);
+        if (index == goal_word) {
+            result |= goal_bit;
+        }
+        return result;
+    };
+
+    if (dx > 0) {
+        const std::size_t first = x + 1;
+        if (first >= width) {
+            return std::nullopt;
+        }
+        for (std::size_t index = first / kWordBits; index < words_per_row; ++index) {
+            const std::uint64_t above_behind
+                = (word(above, index) << 1) | (index > 0 ? word(above, index - 1) >> (kWordBits - 1) : 0);
+            const std::uint64_t below_behind
+                = (word(below, index) << 1) | (index > 0 ? word(below, index - 1) >> (kWordBits - 1) : 0);
+            std::uint64_t candidates = stops(index, above_behind, below_behind);
+            if (index == first / kWordBits) {
+                candidates &= ~std::uint64_t{0} << (first % kWordBits);
+            }
+            if (candidates != 0) {
+                const std::size_t bit = static_cast<std::size_t>(std::countr_zero(candidates));
+                const std::size_t hit = index * kWordBits + bit;
+                if (hit >= width || ((row[index] >> bit) & 1U) == 0) {
+                    return std::nullopt;
+                }
+                return hit;
+            }
+        }
+        return std::nullopt;
+    }
+
+    if (x == 0) {
+        return std::nullopt;
+    }
+    const std::size_t first = x - 1;
+    for (std::size_t index = first / kWordBits + 1; index-- > 0;) {
+        const std::uint64_t above_behind = (word(above, index) >> 1) | (word(above, index + 1) << (kWordBits - 1));
+        const std::uint64_t below_behind = (word(below, index) >> 1) | (word(below, index + 1) << (kWordBits - 1));
+        std::uint64_t candidates = stops(index, above_behind, below_behind);
+        if (index == first / kWordBits && first % kWordBits != kWordBits - 1) {
+            candidates &= (std::uint64_t{1} << (first % kWordBits + 1)) - 1;
+        }
+        if (candidates != 0) {
+            const std::size_t bit = kWordBits - 1 - static_cast<std::size_t>(std::countl_zero(candidates));
+            if (((row[index] >> bit) & 1U) == 0) {
+                return std::nullopt;
+            }
+            return index * kWordBits + bit;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::size_t> JumpPointSearch::jump_vertical(
+    const Plane& plane, std::size_t x, std::size_t y, int dy, const GridPosition& goal) const noexcept {
+    const std::size_t height = map_->height();
+    for (std::size_t row = y;;) {
+        if ((dy < 0 && row == 0) || (dy > 0 && row + 1 >= height)) {
+            return std::nullopt;
+        }
+        row = static_cast<std::size_t>(static_cast<int>(row) + dy);
+        if (!is_open(plane, x, row)) {
+            return std::nullopt;
+        }
+        if (x == goal.x && row == goal.y) {
+            return row;
+        }
+        // Any row the vertical run could turn into and still reach a jump
+        // point makes this cell one.
+        if (jump_horizontal(plane, x, row, 1, goal) || jump_horizontal(plane, x, row, -1, goal)) {
+            return row;
+        }
+    }
+}
+
+void JumpPointSearch::prepare_scratch() {
+    const std::size_t cells = map_->width() * map_->height();
+    if (scratch_.generation.size() != cells) {
+        scratch_.generation.assign(cells, 0);
+        scratch_.cost.resize(cells);
+        scratch_.parent.resize(cells);
+        scratch_.current = 0;
+    }
+    if (++scratch_.current == 0) {
+        std::fill(scratch_.generation.begin(), scratch_.generation.end(), 0);
+        scratch_.current = 1;
+    }
+}
+
+} // namespace towerdefense
@@ -1,6 +1,8 @@
 #include "towerdefense/Map.hpp"
+#include "towerdefense/MapBundle.hpp"
 #include "towerdefense/PathFinder.hpp"
 
+#include <filesystem>
 #include <fstream>
 #include <algorithm>
 #include <sstream>
@@ -48,12 +50,85 @@ char tile_to_char(TileType type) {
     }
     return '?';
 }
+
+bool tile_is_walkable(TileType tile, bool treat_towers_as_walkable) noexcept {
+    if (tile == TileType::Tower) {
+        return treat_towers_as_walkable;
+    }
+    // Force creatures to respect the drawn path by only treating path-like tiles
+    // as walkable terrain. Empty tiles remain available for tower placement.
+    return tile == TileType::Path || tile == TileType::Entry || tile == TileType::Exit || tile == TileType::Resource;
+}
+
+// Spreads reached bits through contiguous open bits, towards higher bit
+// positions (up) or lower ones (down), in log2(64) shift steps.
+std::uint64_t fill_up(std::uint64_t reached, std::uint64_t open) noexcept {
+    for (int shift = 1; shift < 64; shift *= 2) {
+        reached |= (reached << shift) & open;
+        open &= open << shift;
+    }
+    return reached;
+}
+
+std::uint64_t fill_down(std::uint64_t reached, std::uint64_t open) noexcept {
+    for (int shift = 1; shift < 64; shift *= 2) {
+        reached |= (reached >> shift) & open;
+        open &= open >> shift;
+    }
+    return reached;
+}
 } // namespace
 
-Map::Map(std::size_t width, std::size_t height, Grid grid)
+Map::Map(std::size_t width, std::size_t height, Grid grid, Layout layout)
     : width_(width)
     , height_(height)
-    , grid_(std::move(grid)) {}
+    , grid_(std::move(grid))
+    , words_per_row_((width + 63) / 64) {
+    if (grid_.size() != width_ * height_) {
+        throw std::invalid_argument("Map grid does not match its dimensions");
+    }
+    if (width_ * height_ >= kInvalidCell) {
+        throw std::invalid_argument("Map has too many cells for 32-bit cell ids");
+    }
+    for (auto& plane : planes_) {
+        plane.assign(height_ * words_per_row_, 0);
+    }
+    for (std::size_t y = 0; y < height_; ++y) {
+        for (std::size_t x = 0; x < width_; ++x) {
+            const auto tile = grid_[y * width_ + x];
+            const std::size_t word = y * words_per_row_ + x / 64;
+            const std::uint64_t bit = std::uint64_t{1} << (x % 64);
+            planes_[0][word] |= tile_is_walkable(tile, false) ? bit : 0;
+            planes_[1][word] |= tile_is_walkable(tile, true) ? bit : 0;
+            planes_[2][word] |= tile == TileType::Empty ? bit : 0;
+        }
+    }
+    set_layout(layout);
+}
+
+void Map::set_layout(Layout layout) {
+    if (layout == layout_) {
+        return;
+    }
+    Grid row_major(width_ * height_);
+    for_each_cell([&](const GridPosition& pos, TileType tile) { row_major[pos.y * width_ + pos.x] = tile; });
+
+    layout_ = layout;
+    if (layout_ == Layout::RowMajor) {
+        grid_ = std::move(row_major);
+        tiles_per_row_ = 0;
+        return;
+    }
+    // Edge tiles are padded to full size so every tile has the same stride.
+    tiles_per_row_ = (width_ + kTileSize - 1) / kTileSize;
+    const std::size_t tile_rows = (height_ + kTileSize - 1) / kTileSize;
+    grid_.assign(tiles_per_row_ * tile_rows * kTileSize * kTileSize, TileType::Blocked);
+    for (std::size_t y = 0; y < height_; ++y) {
+        for (std::size_t x = 0; x < width_; ++x) {
+            grid_[storage_index(x, y)] = row_major[y * width_ + x];
+        }
+    }
+}
 
 namespace {
 
@@ -67,40 +142,16 @@ void prune_unused_paths(Map& map) {
     } catch (...) {
         return;
     }
-    std::vector<std::vector<bool>> visited(map.height(), std::vector<bool>(map.width(), false));
-    std::queue<GridPosition> frontier;
-    for (const auto& entry : map.entries()) {
-        frontier.push(entry);
-        visited[entry.y][entry.x] = true;
-    }
-    const std::array<std::pair<int, int>, 4> dirs{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
-    while (!frontier.empty()) {
-        GridPosition current = frontier.front();
-        frontier.pop();
-        for (const auto& [dx, dy] : dirs) {
-            int nx = static_cast<int>(current.x) + dx;
-            int ny = static_cast<int>(current.y) + dy;
-            if (nx < 0 || ny < 0 || nx >= static_cast<int>(map.width()) || ny >= static_cast<int>(map.height())) {
-                continue;
-            }
-            GridPosition next{static_cast<std::size_t>(nx), static_cast<std::size_t>(ny)};
-            if (visited[next.y][next.x]) {
-                continue;
-            }
-            if (!map.is_walkable(next, true)) {
-                continue;
-            }
-            visited[next.y][next.x] = true;
-            frontier.push(next);
-        }
-    }
-    for (std::size_t y = 0; y < map.height(); ++y) {
-        for (std::size_t x = 0; x < map.width(); ++x) {
-            GridPosition pos{x, y};
-            if (map.at(pos) == TileType::Path && !visited[y][x]) {
-                map.set(pos, TileType::Empty);
-            }
+    const auto reached = map.reachable_from(map.entries(), Map::Plane::WalkableIgnoringTowers);
+    std::vector<GridPosition> unused;
+    map.for_each_cell([&](const GridPosition& pos, TileType tile) {
+        const bool visited = (reached[pos.y * map.words_per_row() + pos.x / 64] >> (pos.x % 64)) & 1U;
+        if (tile == TileType::Path && !visited) {
+            unused.push_back(pos);
         }
+    });
+    for (const auto& pos : unused) {
+        map.set(pos, TileType::Empty);
     }
 }
 
@@ -155,7 +206,7 @@ Map build_from_lines(const std::vector<std::string>& lines, const std::string& s
     // Relocate the crystal to the farthest reachable walkable tile from any entry
     // so that maps emphasize a long journey to the goal.
     if (resource) {
-        PathFinder finder{map};
+        PathFinder finder{map, PathCache::kDefaultMemoryBudget, PathFinder::Strategy::Flat};
         double best_distance = -1.0;
         GridPosition best_pos = *resource;
         for (const auto& entry : map.entries()) {
@@ -206,14 +257,16 @@ Map build_from_lines(const std::vector<std::string>& lines, const std::string& s
     }
 
     // Validate that at least one path to the crystal exists along walkable tiles.
-    PathFinder checker{map};
-    bool reachable = false;
+    const auto& crystal = map.resource_position();
+    std::vector<GridPosition> walkable_entries;
     for (const auto& entry : map.entries()) {
-        if (checker.shortest_path(entry, map.resource_position())) {
-            reachable = true;
-            break;
+        if (map.is_walkable(entry)) {
+            walkable_entries.push_back(entry);
         }
     }
+    const auto reached = map.reachable_from(walkable_entries, Map::Plane::Walkable);
+    const bool reachable = map.is_walkable(crystal)
+        && ((reached[crystal.y * map.words_per_row() + crystal.x / 64] >> (crystal.x % 64)) & 1U);
     if (!reachable) {
         throw std::runtime_error("No walkable path from any entry to the crystal in map: " + source);
     }
@@ -225,6 +278,9 @@ Map build_from_lines(const std::vector<std::string>& lines, const std::string& s
 } // namespace
 
 Map Map::load_from_file(const std::string& path) {
+    if (std::filesystem::path{path}.extension() == MapBundle::kExtension) {
+        return MapBundle::load(path);
+    }
     std::ifstream file{path};
     if (!file) {
         throw std::runtime_error("Failed to open map file: " + path);
@@ -274,15 +330,17 @@ TileType Map::at(const GridPosition& pos) const {
     if (!is_within_bounds(pos)) {
         throw std::out_of_range("Position out of bounds: " + pos.to_string());
     }
-    return grid_[pos.y * width_ + pos.x];
+    return grid_[storage_index(pos.x, pos.y)];
 }
 
 void Map::set(const GridPosition& pos, TileType type) {
     if (!is_within_bounds(pos)) {
         throw std::out_of_range("Position out of bounds: " + pos.to_string());
     }
-    auto& tile = grid_[pos.y * width_ + pos.x];
+    auto& tile = grid_[storage_index(pos.x, pos.y)];
     tile = type;
+    update_planes(pos, type);
+    distance_fields_.reset();
 }
 
 bool Map::is_within_bounds(const GridPosition& pos) const noexcept {
@@ -293,13 +351,85 @@ bool Map::is_walkable(const GridPosition& pos, bool treat_towers_as_walkable) co
     if (!is_within_bounds(pos)) {
         return false;
     }
-    const auto tile = grid_[pos.y * width_ + pos.x];
-    if (tile == TileType::Tower) {
-        return treat_towers_as_walkable;
+    return test(treat_towers_as_walkable ? Plane::WalkableIgnoringTowers : Plane::Walkable, pos);
+}
+
+bool Map::is_buildable(const GridPosition& pos) const noexcept {
+    return is_within_bounds(pos) && test(Plane::Buildable, pos);
+}
+
+std::vector<std::uint64_t> Map::reachable_from(std::span<const GridPosition> sources, Plane plane) const {
+    const auto& open = planes_[static_cast<std::size_t>(plane)];
+    std::vector<std::uint64_t> reached(open.size(), 0);
+    std::vector<std::size_t> pending;
+    std::vector<std::uint8_t> queued(height_, 0);
+    for (const auto& source : sources) {
+        if (!is_within_bounds(source)) {
+            continue;
+        }
+        reached[source.y * words_per_row_ + source.x / 64] |= std::uint64_t{1} << (source.x % 64);
+        if (!queued[source.y]) {
+            queued[source.y] = 1;
+            pending.push_back(source.y);
+        }
+    }
+
+    // Each pending row is flooded sideways a word at a time, then pushes the
+    // newly reached bits into the open cells directly above and below it.
+    while (!pending.empty()) {
+        const std::size_t y = pending.back();
+        pending.pop_back();
+        queued[y] = 0;
+        std::uint64_t* row = reached.data() + y * words_per_row_;
+        const std::uint64_t* open_row = open.data() + y * words_per_row_;
+        // Sources may sit on closed cells, so let them pass on their own bit.
+        std::uint64_t carry = 0;
+        for (std::size_t w = 0; w < words_per_row_; ++w) {
+            const std::uint64_t passable = open_row[w] | row[w];
+            row[w] = fill_up(row[w] | (carry & passable), passable);
+            carry = row[w] >> 63;
+        }
+        carry = 0;
+        for (std::size_t w = words_per_row_; w-- > 0;) {
+            const std::uint64_t passable = open_row[w] | row[w];
+            row[w] = fill_down(row[w] | ((carry << 63) & passable), passable);
+            carry = row[w] & 1U;
+        }
+        for (const std::size_t next : {y - 1, y + 1}) {
+            if (next >= height_) {
+                continue;
+            }
+            std::uint64_t* next_row = reached.data() + next * words_per_row_;
+            const std::uint64_t* next_open = open.data() + next * words_per_row_;
+            bool grew = false;
+            for (std::size_t w = 0; w < words_per_row_; ++w) {
+                const std::uint64_t gained = row[w] & next_open[w] & ~next_row[w];
+                if (gained != 0) {
+                    next_row[w] |= gained;
+                    grew = true;
+                }
+            }
+            if (grew && !queued[next]) {
+                queued[next] = 1;
+                pending.push_back(next);
+            }
+        }
+    }
+    return reached;
+}
+
+void Map::update_planes(const GridPosition& pos, TileType type) noexcept {
+    const std::size_t word = pos.y * words_per_row_ + pos.x / 64;
+    const std::uint64_t bit = std::uint64_t{1} << (pos.x % 64);
+    const std::array<bool, 3> values{
+        tile_is_walkable(type, false), tile_is_walkable(type, true), type == TileType::Empty};
+    for (std::size_t i = 0; i < planes_.size(); ++i) {
+        if (values[i]) {
+            planes_[i][word] |= bit;
+        } else {
+            planes_[i][word] &= ~bit;
+        }
     }
-    // Force creatures to respect the drawn path by only treating path-like tiles
-    // as walkable terrain. Empty tiles remain available for tower placement.
-    return tile == TileType::Path || tile == TileType::Entry || tile == TileType::Exit || tile == TileType::Resource;
 }
 
 const GridPosition& Map::resource_position() const {
@@ -309,22 +439,30 @@ const GridPosition& Map::resource_position() const {
     return *resource_;
 }
 
-std::vector<std::string> Map::render_with_entities(
-    const std::unordered_map<GridPosition, char, GridPositionHash>& entity_symbols) const {
+std::vector<std::string> Map::render_with_entities(const std::unordered_map<CellId, char>& entity_symbols) const {
     std::vector<std::string> result(height_, std::string(width_, '.'));
-    for (std::size_t y = 0; y < height_; ++y) {
-        for (std::size_t x = 0; x < width_; ++x) {
-            result[y][x] = tile_to_char(grid_[y * width_ + x]);
+    for_each_cell([&](const GridPosition& pos, TileType tile) { result[pos.y][pos.x] = tile_to_char(tile); });
+
+    for (const auto& [cell, symbol] : entity_symbols) {
+        if (cell < cell_count()) {
+            const auto pos = position_of(cell);
+            result[pos.y][pos.x] = symbol;
         }
     }
 
+    return result;
+}
+
+std::vector<std::string> Map::render_with_entities(
+    const std::unordered_map<GridPosition, char, GridPositionHash>& entity_symbols) const {
+    std::unordered_map<CellId, char> symbols;
+    symbols.reserve(entity_symbols.size());
     for (const auto& [pos, symbol] : entity_symbols) {
         if (is_within_bounds(pos)) {
-            result[pos.y][pos.x] = symbol;
+            symbols[cell_id(pos)] = symbol;
         }
     }
-
-    return result;
+    return render_with_entities(symbols);
 }
 
 } // namespace towerdefense
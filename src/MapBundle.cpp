@@ -0,0 +1,344 @@
+#include "towerdefense/MapBundle.hpp"
+#include "towerdefense/FlowField.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace towerdefense {
+
+namespace {
+constexpr std::array<char, 8> kMagic{'T', 'D', 'M', 'A', 'P', '\0', '\0', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr std::uint32_t kHasResource = 1u;
+
+struct Header {
+    std::array<char, 8> magic{};
+    std::uint32_t version{};
+    std::uint32_t byte_order{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::uint32_t entry_count{};
+    std::uint32_t exit_count{};
+    std::uint32_t resource_x{};
+    std::uint32_t resource_y{};
+    std::uint32_t flags{};
+    std::uint32_t reserved{};
+    std::uint64_t tiles_offset{};
+    std::uint64_t entries_offset{};
+    std::uint64_t exits_offset{};
+    std::uint64_t resource_field_offset{};
+    std::uint64_t exit_field_offset{};
+    std::uint64_t file_size{};
+};
+
+std::uint64_t align8(std::uint64_t offset) {
+    return (offset + 7) & ~std::uint64_t{7};
+}
+
+// Whether count items of item_size bytes at offset start after the header
+// and end by limit, the next section's offset or the file size. Nothing is
+// added, so no sum can wrap.
+bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t item_size, std::uint64_t limit) {
+    if (offset < sizeof(Header) || offset > limit) {
+        return false;
+    }
+    return count <= (limit - offset) / item_size;
+}
+
+// Read-only view of a whole file, unmapped on destruction.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+        file_ = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open map bundle: " + path.string());
+        }
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ != nullptr) {
+                data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (data_ == nullptr) {
+                release();
+                throw std::runtime_error("Failed to map map bundle: " + path.string());
+            }
+        }
+#else
+        descriptor_ = ::open(path.c_str(), O_RDONLY);
+        if (descriptor_ < 0) {
+            throw std::runtime_error("Failed to open map bundle: " + path.string());
+        }
+        struct stat info{};
+        if (::fstat(descriptor_, &info) != 0) {
+            release();
+            throw std::runtime_error("Failed to stat map bundle: " + path.string());
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor_, 0);
+            if (address == MAP_FAILED) {
+                release();
+                throw std::runtime_error("Failed to map map bundle: " + path.string());
+            }
+            data_ = static_cast<const unsigned char*>(address);
+        }
+#endif
+    }
+
+    ~MappedFile() { release(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const unsigned char* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+    const unsigned char* data_{nullptr};
+    std::size_t size_{};
+#ifdef _WIN32
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int descriptor_{-1};
+#endif
+
+    void release() noexcept {
+#ifdef _WIN32
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) {
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+        }
+        if (descriptor_ >= 0) {
+            ::close(descriptor_);
+        }
+        descriptor_ = -1;
+#endif
+        data_ = nullptr;
+    }
+};
+
+void write_positions(std::ofstream& out, const std::vector<GridPosition>& positions) {
+    for (const auto& pos : positions) {
+        const std::array<std::uint32_t, 2> pair{static_cast<std::uint32_t>(pos.x), static_cast<std::uint32_t>(pos.y)};
+        out.write(reinterpret_cast<const char*>(pair.data()), sizeof(pair));
+    }
+}
+
+void pad_to(std::ofstream& out, std::uint64_t offset) {
+    static constexpr std::array<char, 8> zeros{};
+    const auto position = static_cast<std::uint64_t>(out.tellp());
+    out.write(zeros.data(), static_cast<std::streamsize>(offset - position));
+}
+
+std::vector<GridPosition> read_positions(const unsigned char* data, std::uint32_t count, const Header& header) {
+    std::vector<GridPosition> positions;
+    positions.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::array<std::uint32_t, 2> pair{};
+        std::memcpy(pair.data(), data + i * sizeof(pair), sizeof(pair));
+        if (pair[0] >= header.width || pair[1] >= header.height) {
+            throw std::runtime_error("Map bundle position out of bounds");
+        }
+        positions.push_back(GridPosition{pair[0], pair[1]});
+    }
+    return positions;
+}
+
+// Whether a stored distance field is one FlowField could have built: every
+// walkable goal is 0 and every other reached cell is walkable, below the
+// cell count and one step above a neighbour. Walking downhill from any
+// reached cell then ends on a goal within cell_count steps.
+bool field_is_consistent(const Map& map, std::span<const std::uint32_t> distance, std::span<const GridPosition> goals) {
+    const std::size_t width = map.width();
+    const std::size_t height = map.height();
+    const std::size_t cells = map.cell_count();
+    std::vector<bool> is_goal(cells, false);
+    for (const auto& goal : goals) {
+        const auto index = map.cell_id(goal);
+        is_goal[index] = true;
+        if (map.is_walkable(goal) && distance[index] != 0) {
+            return false;
+        }
+    }
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            const std::size_t index = y * width + x;
+            const std::uint32_t value = distance[index];
+            if (value == FlowField::kUnreachable) {
+                continue;
+            }
+            if (value >= cells || !map.is_walkable(GridPosition{x, y})) {
+                return false;
+            }
+            if (value == 0) {
+                if (!is_goal[index]) {
+                    return false;
+                }
+                continue;
+            }
+            const bool downhill = (x > 0 && distance[index - 1] == value - 1)
+                || (x + 1 < width && distance[index + 1] == value - 1)
+                || (y > 0 && distance[index - width] == value - 1)
+                || (y + 1 < height && distance[index + width] == value - 1);
+            if (!downhill) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+void MapBundle::write(const Map& map, const std::filesystem::path& path) {
+    const std::uint64_t cells = static_cast<std::uint64_t>(map.width()) * map.height();
+    Header header;
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.width = static_cast<std::uint32_t>(map.width());
+    header.height = static_cast<std::uint32_t>(map.height());
+    header.entry_count = static_cast<std::uint32_t>(map.entries().size());
+    header.exit_count = static_cast<std::uint32_t>(map.exits().size());
+    std::vector<std::uint32_t> to_resource(cells, FlowField::kUnreachable);
+    std::vector<std::uint32_t> to_exit(cells, FlowField::kUnreachable);
+    FlowField fields{map};
+    try {
+        const auto& resource = map.resource_position();
+        header.resource_x = static_cast<std::uint32_t>(resource.x);
+        header.resource_y = static_cast<std::uint32_t>(resource.y);
+        header.flags |= kHasResource;
+        to_resource = fields.resource_distances();
+    } catch (const std::runtime_error&) {
+        // No resource: every cell stays unreachable.
+    }
+    to_exit = fields.exit_distances();
+
+    header.tiles_offset = align8(sizeof(Header));
+    header.entries_offset = align8(header.tiles_offset + cells);
+    header.exits_offset = align8(header.entries_offset + header.entry_count * 8ULL);
+    header.resource_field_offset = align8(header.exits_offset + header.exit_count * 8ULL);
+    header.exit_field_offset = header.resource_field_offset + cells * sizeof(std::uint32_t);
+    header.file_size = header.exit_field_offset + cells * sizeof(std::uint32_t);
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    if (!out) {
+        throw std::runtime_error("Failed to open map bundle for writing: " + path.string());
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad_to(out, header.tiles_offset);
+    std::vector<std::uint8_t> tiles(cells);
+    map.for_each_cell([&](const GridPosition& pos, TileType tile) {
+        tiles[pos.y * map.width() + pos.x] = static_cast<std::uint8_t>(tile);
+    });
+    out.write(reinterpret_cast<const char*>(tiles.data()), static_cast<std::streamsize>(tiles.size()));
+    pad_to(out, header.entries_offset);
+    write_positions(out, map.entries());
+    pad_to(out, header.exits_offset);
+    write_positions(out, map.exits());
+    pad_to(out, header.resource_field_offset);
+    out.write(reinterpret_cast<const char*>(to_resource.data()), static_cast<std::streamsize>(cells * sizeof(std::uint32_t)));
+    out.write(reinterpret_cast<const char*>(to_exit.data()), static_cast<std::streamsize>(cells * sizeof(std::uint32_t)));
+    if (!out) {
+        throw std::runtime_error("Failed to write map bundle: " + path.string());
+    }
+}
+
+Map MapBundle::load(const std::filesystem::path& path) {
+    const MappedFile file{path};
+    Header header;
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error("Map bundle is truncated: " + path.string());
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.magic != kMagic) {
+        throw std::runtime_error("Not a map bundle: " + path.string());
+    }
+    if (header.version != kVersion || header.byte_order != kByteOrderMark) {
+        throw std::runtime_error("Unsupported map bundle version or byte order: " + path.string());
+    }
+    const std::uint64_t cells = static_cast<std::uint64_t>(header.width) * header.height;
+    // Each section must end by the next one's start and the last by the end
+    // of the file, which keeps them in order and inside the mapping.
+    if (cells == 0 || header.file_size != file.size()
+        || !section_fits(header.tiles_offset, cells, 1, header.entries_offset)
+        || !section_fits(header.entries_offset, header.entry_count, 8, header.exits_offset)
+        || !section_fits(header.exits_offset, header.exit_count, 8, header.resource_field_offset)
+        || !section_fits(header.resource_field_offset, cells, sizeof(std::uint32_t), header.exit_field_offset)
+        || !section_fits(header.exit_field_offset, cells, sizeof(std::uint32_t), file.size())) {
+        throw std::runtime_error("Map bundle is corrupt: " + path.string());
+    }
+
+    const unsigned char* tiles = file.data() + header.tiles_offset;
+    Map::Grid grid(cells);
+    for (std::uint64_t i = 0; i < cells; ++i) {
+        if (tiles[i] > static_cast<std::uint8_t>(TileType::Blocked)) {
+            throw std::runtime_error("Map bundle has an unknown tile: " + path.string());
+        }
+        grid[i] = static_cast<TileType>(tiles[i]);
+    }
+
+    auto fields = std::make_shared<Map::DistanceFields>();
+    fields->to_resource.resize(cells);
+    fields->to_exit.resize(cells);
+    std::memcpy(fields->to_resource.data(), file.data() + header.resource_field_offset, cells * sizeof(std::uint32_t));
+    std::memcpy(fields->to_exit.data(), file.data() + header.exit_field_offset, cells * sizeof(std::uint32_t));
+
+    Map map{header.width, header.height, std::move(grid)};
+    map.set_entries(read_positions(file.data() + header.entries_offset, header.entry_count, header));
+    map.set_exits(read_positions(file.data() + header.exits_offset, header.exit_count, header));
+    if (header.flags & kHasResource) {
+        if (header.resource_x >= header.width || header.resource_y >= header.height) {
+            throw std::runtime_error("Map bundle position out of bounds");
+        }
+        map.set_resource(GridPosition{header.resource_x, header.resource_y});
+    }
+    // FlowField walks these fields as they are, so a bad one is rejected here
+    // rather than sending a route off the map.
+    std::vector<GridPosition> resource_goal;
+    if (header.flags & kHasResource) {
+        resource_goal.push_back(map.resource_position());
+    }
+    if (!field_is_consistent(map, fields->to_resource, resource_goal)
+        || !field_is_consistent(map, fields->to_exit, map.exits())) {
+        throw std::runtime_error("Map bundle is corrupt: " + path.string());
+    }
+    map.set_distance_fields(std::move(fields));
+    return map;
+}
+
+} // namespace towerdefense
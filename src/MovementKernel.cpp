@@ -0,0 +1,114 @@
+#include "towerdefense/MovementKernel.hpp"
+
+#include "towerdefense/CpuFeatures.hpp"
+
+#include <bit>
+
+// Results must match bit for bit between kernels, so this file is built
+// without floating-point contraction (see CMakeLists.txt): a fused
+// multiply-add in one kernel and not the other would round differently.
+
+namespace towerdefense {
+
+namespace {
+
+bool advance_lane(const MovementLanes& lanes, std::size_t i) noexcept {
+    if (lanes.health[i] <= 0 || (lanes.flags[i] & lanes.routed_flag) == 0) {
+        return false;
+    }
+    if (lanes.slow_duration[i] > 0) {
+        --lanes.slow_duration[i];
+    } else {
+        lanes.slow_factor[i] = 1.0;
+    }
+    lanes.progress[i] += lanes.speed[i] * lanes.slow_factor[i];
+    return lanes.progress[i] >= 1.0;
+}
+
+std::size_t advance_scalar(const MovementLanes& lanes, std::size_t begin, std::uint32_t* steps, std::size_t written) noexcept {
+    for (std::size_t i = begin; i < lanes.count; ++i) {
+        if (advance_lane(lanes, i)) {
+            steps[written++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return written;
+}
+
+#ifdef TOWERDEFENSE_X86_KERNELS
+
+// Four double lanes starting at i; moving and reset are the matching int32
+// masks. Returns the lanes whose progress reached a whole step.
+TOWERDEFENSE_TARGET_AVX2 int advance_quad(
+    const MovementLanes& lanes, std::size_t i, __m128i moving_half, __m128i reset_half) noexcept {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d moving = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(moving_half));
+    const __m256d reset = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(reset_half));
+
+    const __m256d factor = _mm256_blendv_pd(_mm256_loadu_pd(lanes.slow_factor + i), one, reset);
+    _mm256_storeu_pd(lanes.slow_factor + i, factor);
+
+    const __m256d progress = _mm256_loadu_pd(lanes.progress + i);
+    const __m256d advanced = _mm256_add_pd(progress, _mm256_mul_pd(_mm256_loadu_pd(lanes.speed + i), factor));
+    const __m256d updated = _mm256_blendv_pd(progress, advanced, moving);
+    _mm256_storeu_pd(lanes.progress + i, updated);
+
+    return _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(updated, one, _CMP_GE_OQ), moving));
+}
+
+// Eight creatures per iteration: timers and masks as one 8 x int32 vector,
+// the double fields as two 4 x double halves.
+TOWERDEFENSE_TARGET_AVX2 std::size_t advance_avx2(const MovementLanes& lanes, std::uint32_t* steps) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i routed = _mm256_set1_epi32(lanes.routed_flag);
+    std::size_t written = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= lanes.count; i += 8) {
+        const __m256i health = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.health + i));
+        const __m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes.flags + i)));
+        const __m256i unrouted = _mm256_cmpeq_epi32(_mm256_and_si256(flags, routed), zero);
+        const __m256i moving = _mm256_andnot_si256(unrouted, _mm256_cmpgt_epi32(health, zero));
+        if (_mm256_testz_si256(moving, moving)) {
+            continue;
+        }
+
+        // Slowed lanes count down by adding their all-ones mask (-1); the
+        // others go back to full speed.
+        auto* duration_ptr = reinterpret_cast<__m256i*>(lanes.slow_duration + i);
+        const __m256i duration = _mm256_loadu_si256(duration_ptr);
+        const __m256i slowed = _mm256_cmpgt_epi32(duration, zero);
+        _mm256_storeu_si256(duration_ptr, _mm256_add_epi32(duration, _mm256_and_si256(slowed, moving)));
+        const __m256i reset = _mm256_andnot_si256(slowed, moving);
+
+        unsigned ready = static_cast<unsigned>(
+            advance_quad(lanes, i, _mm256_castsi256_si128(moving), _mm256_castsi256_si128(reset)));
+        ready |= static_cast<unsigned>(
+                     advance_quad(lanes, i + 4, _mm256_extracti128_si256(moving, 1), _mm256_extracti128_si256(reset, 1)))
+            << 4;
+        while (ready != 0) {
+            steps[written++] = static_cast<std::uint32_t>(i + static_cast<std::size_t>(std::countr_zero(ready)));
+            ready &= ready - 1;
+        }
+    }
+    return advance_scalar(lanes, i, steps, written);
+}
+
+#endif
+
+} // namespace
+
+MovementKernel best_movement_kernel() noexcept {
+    return cpu_has_avx2() ? MovementKernel::Avx2 : MovementKernel::Scalar;
+}
+
+std::size_t advance_movement(const MovementLanes& lanes, std::uint32_t* steps, MovementKernel kernel) noexcept {
+#ifdef TOWERDEFENSE_X86_KERNELS
+    if (kernel == MovementKernel::Avx2 && best_movement_kernel() == MovementKernel::Avx2) {
+        return advance_avx2(lanes, steps);
+    }
+#else
+    (void)kernel;
+#endif
+    return advance_scalar(lanes, 0, steps, 0);
+}
+
+} // namespace towerdefense
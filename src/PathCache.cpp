@@ -0,0 +1,78 @@
+#include "towerdefense/PathCache.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace towerdefense {
+
+PathCache::PathCache(std::size_t memory_budget_bytes)
+    : memory_budget_(memory_budget_bytes) {}
+
+std::uint64_t PathCache::make_key(CellId start_cell, CellId goal_cell, bool ignore_towers) noexcept {
+    return (static_cast<std::uint64_t>(start_cell) << 33) | (static_cast<std::uint64_t>(goal_cell) << 1)
+        | static_cast<std::uint64_t>(ignore_towers);
+}
+
+const RouteHandle* PathCache::find(std::uint64_t key) {
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    if (it->second->generation != generation_) {
+        erase(it->second);
+        ++stats_.expired;
+        ++stats_.misses;
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++stats_.hits;
+    return &entries_.front().route;
+}
+
+void PathCache::insert(std::uint64_t key, RouteHandle route) {
+    if (const auto it = index_.find(key); it != index_.end()) {
+        erase(it->second);
+    }
+    entries_.push_front(Entry{key, generation_, std::move(route)});
+    index_.emplace(key, entries_.begin());
+    memory_usage_ += footprint(entries_.front());
+    enforce_budget();
+}
+
+void PathCache::clear() {
+    entries_.clear();
+    index_.clear();
+    memory_usage_ = 0;
+}
+
+void PathCache::set_memory_budget(std::size_t bytes) {
+    memory_budget_ = bytes;
+    enforce_budget();
+}
+
+std::size_t PathCache::footprint(const Entry& entry) noexcept {
+    // List node, index node and the route payload.
+    constexpr std::size_t node_overhead = 2 * sizeof(void*) + sizeof(std::uint64_t) + sizeof(EntryList::iterator) + sizeof(void*);
+    return sizeof(Entry) + node_overhead + (entry.route ? entry.route->memory_footprint() : 0);
+}
+
+void PathCache::erase(EntryList::iterator it) {
+    memory_usage_ -= footprint(*it);
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+void PathCache::enforce_budget() {
+    while (memory_usage_ > memory_budget_ && !entries_.empty()) {
+        const auto oldest = std::prev(entries_.end());
+        if (oldest->generation == generation_) {
+            ++stats_.evictions;
+        } else {
+            ++stats_.expired;
+        }
+        erase(oldest);
+    }
+}
+
+} // namespace towerdefense
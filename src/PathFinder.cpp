@@ -2,8 +2,6 @@
 
 #include <algorithm>
 #include <array>
-#include <queue>
-#include <unordered_map>
 
 namespace towerdefense {
 
@@ -11,100 +9,207 @@ namespace {
 constexpr std::array<std::pair<int, int>, 4> directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
 }
 
-PathFinder::PathFinder(const Map& map)
-    : map_(&map) {}
+PathFinder::PathFinder(const Map& map, std::size_t cache_budget_bytes, Strategy strategy)
+    : map_(&map)
+    , cache_(cache_budget_bytes) {
+    const bool large = map.width() * map.height() >= kHierarchicalThreshold;
+    if (strategy == Strategy::Hierarchical || (strategy == Strategy::Automatic && large)) {
+        hierarchy_.emplace(map);
+    } else if (strategy == Strategy::JumpPoint || strategy == Strategy::Automatic) {
+        jump_points_.emplace(map);
+    }
+}
 
 std::optional<std::vector<GridPosition>> PathFinder::shortest_path(
     const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze) {
+    if (auto route = shortest_route(start, goal, allow_tower_squeeze)) {
+        return route->to_positions();
+    }
+    return std::nullopt;
+}
+
+RouteHandle PathFinder::shortest_route(const GridPosition& start, const GridPosition& goal, bool allow_tower_squeeze) {
+    if (!map_->is_within_bounds(start) || !map_->is_within_bounds(goal)) {
+        return nullptr;
+    }
     const int attempts = allow_tower_squeeze ? 2 : 1;
     for (int i = 0; i < attempts; ++i) {
         const bool ignore_towers = (i == 1);
-        const auto key = compute_cache_key(start, goal, ignore_towers) ^ cache_version_;
-        if (auto it = cache_.find(key); it != cache_.end()) {
-            if (!it->second.empty()) {
-                return it->second;
+        const auto key = compute_cache_key(start, goal, ignore_towers);
+        if (const RouteHandle* cached = cache_.find(key)) {
+            if (*cached) {
+                return *cached;
             }
             if (ignore_towers) {
-                return std::nullopt;
+                return nullptr;
             }
             continue;
         }
 
-        if (auto path = bfs(start, goal, ignore_towers)) {
-            cache_.emplace(key, *path);
-            return path;
+        std::optional<Path> path;
+        if (hierarchy_) {
+            path = hierarchy_->find_path(start, goal, ignore_towers);
+        } else if (jump_points_) {
+            path = jump_points_->find_path(start, goal, ignore_towers);
+        } else {
+            path = bfs(start, std::span<const GridPosition>(&goal, 1), ignore_towers);
+        }
+        if (path) {
+            auto route = Route::from_positions(*path);
+            cache_.insert(key, route);
+            return route;
         }
         // store negative result to prevent repeated work
-        cache_.emplace(key, Path{});
+        cache_.insert(key, nullptr);
     }
 
+    return nullptr;
+}
+
+std::optional<std::vector<GridPosition>> PathFinder::shortest_path_to_any(
+    const GridPosition& start, std::span<const GridPosition> goals, bool allow_tower_squeeze) {
+    const int attempts = allow_tower_squeeze ? 2 : 1;
+    for (int i = 0; i < attempts; ++i) {
+        if (auto path = bfs(start, goals, i == 1)) {
+            return path;
+        }
+    }
     return std::nullopt;
 }
 
+void PathFinder::update_cell(const GridPosition& position) {
+    cache_.advance_generation();
+    if (hierarchy_) {
+        hierarchy_->update_cell(position);
+    }
+}
+
 void PathFinder::invalidate_cache() {
-    cache_.clear();
-    ++cache_version_;
+    cache_.advance_generation();
+    if (hierarchy_) {
+        hierarchy_->invalidate();
+    }
 }
 
-std::size_t PathFinder::compute_cache_key(const GridPosition& start, const GridPosition& goal, bool ignore_towers) const noexcept {
-    const std::size_t base = (start.x << 24) ^ (start.y << 16) ^ (goal.x << 8) ^ goal.y;
-    return (base << 1) ^ static_cast<std::size_t>(ignore_towers);
+std::uint64_t PathFinder::compute_cache_key(const GridPosition& start, const GridPosition& goal, bool ignore_towers) const noexcept {
+    const auto width = map_->width();
+    return PathCache::make_key(to_cell_id(start, width), to_cell_id(goal, width), ignore_towers);
 }
 
 std::optional<std::vector<GridPosition>> PathFinder::bfs(
-    const GridPosition& start, const GridPosition& goal, bool ignore_towers) const {
-    if (!map_->is_walkable(start, ignore_towers) || !map_->is_walkable(goal, ignore_towers)) {
+    const GridPosition& start, std::span<const GridPosition> goals, bool ignore_towers) {
+    if (!map_->is_walkable(start, ignore_towers)) {
         return std::nullopt;
     }
 
-    std::queue<GridPosition> frontier;
-    std::unordered_map<std::size_t, GridPosition> came_from;
-    auto encode = [this](const GridPosition& pos) { return pos.y * map_->width() + pos.x; };
-
-    frontier.push(start);
-    came_from.emplace(encode(start), start);
+    prepare_scratch();
+    const std::size_t width = map_->width();
+    const std::size_t height = map_->height();
+    const std::uint32_t generation = scratch_.generation;
+    auto* visited = scratch_.visited_generation.data();
+    auto* came_from = scratch_.came_from.data();
+    auto* goal_generation = scratch_.goal_generation.data();
+    auto* goal_rank = scratch_.goal_rank.data();
+    // Every cell is enqueued at most once, so a buffer of width * height
+    // entries holds the whole frontier without wrapping.
+    auto* frontier = scratch_.frontier.data();
+    std::size_t head = 0;
+    std::size_t tail = 0;
+
+    bool any_goal = false;
+    for (std::size_t rank = goals.size(); rank-- > 0;) {
+        const auto& goal = goals[rank];
+        if (!map_->is_walkable(goal, ignore_towers)) {
+            continue;
+        }
+        const auto index = to_cell_id(goal, width);
+        goal_generation[index] = generation;
+        goal_rank[index] = static_cast<std::uint32_t>(rank);
+        any_goal = true;
+    }
+    if (!any_goal) {
+        return std::nullopt;
+    }
 
-    while (!frontier.empty()) {
-        const auto current = frontier.front();
-        frontier.pop();
+    const auto start_index = to_cell_id(start, width);
+    visited[start_index] = generation;
+    came_from[start_index] = start_index;
+    frontier[tail++] = start_index;
 
-        if (current == goal) {
+    std::optional<CellId> goal_index;
+    std::size_t level_end = tail;
+    while (head < tail) {
+        if (head == level_end) {
+            level_end = tail;
+        }
+        const CellId current = frontier[head++];
+        if (goal_generation[current] == generation) {
+            // Everything at this depth is already queued; prefer the goal
+            // listed first among those that are equally close.
+            goal_index = current;
+            for (std::size_t i = head; i < level_end; ++i) {
+                const CellId other = frontier[i];
+                if (goal_generation[other] == generation && goal_rank[other] < goal_rank[*goal_index]) {
+                    goal_index = other;
+                }
+            }
             break;
         }
 
-        for (const auto [dx, dy] : directions) {
-            const int next_x = static_cast<int>(current.x) + dx;
-            const int next_y = static_cast<int>(current.y) + dy;
-            if (next_x < 0 || next_y < 0) {
+        const std::size_t x = current % width;
+        const std::size_t y = current / width;
+        for (const auto& [dx, dy] : directions) {
+            const int next_x = static_cast<int>(x) + dx;
+            const int next_y = static_cast<int>(y) + dy;
+            if (next_x < 0 || next_y < 0 || next_x >= static_cast<int>(width) || next_y >= static_cast<int>(height)) {
                 continue;
             }
-            const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
-            if (!map_->is_within_bounds(next) || !map_->is_walkable(next, ignore_towers)) {
+            const auto encoded = static_cast<CellId>(static_cast<std::size_t>(next_y) * width + static_cast<std::size_t>(next_x));
+            if (visited[encoded] == generation) {
                 continue;
             }
-            const auto encoded = encode(next);
-            if (came_from.find(encoded) != came_from.end()) {
+            const GridPosition next{static_cast<std::size_t>(next_x), static_cast<std::size_t>(next_y)};
+            if (!map_->is_walkable(next, ignore_towers)) {
                 continue;
             }
-            frontier.push(next);
-            came_from.emplace(encoded, current);
+            visited[encoded] = generation;
+            came_from[encoded] = current;
+            frontier[tail++] = encoded;
         }
     }
 
-    const auto goal_encoded = encode(goal);
-    if (came_from.find(goal_encoded) == came_from.end()) {
+    if (!goal_index) {
         return std::nullopt;
     }
 
-    std::vector<GridPosition> path;
-    GridPosition current = goal;
-    while (current != start) {
-        path.push_back(current);
-        current = came_from.at(encode(current));
+    std::size_t length = 1;
+    for (CellId current = *goal_index; current != start_index; current = came_from[current]) {
+        ++length;
+    }
+    Path path(length);
+    CellId current = *goal_index;
+    for (std::size_t i = length; i-- > 0;) {
+        path[i] = GridPosition{current % width, current / width};
+        current = came_from[current];
     }
-    path.push_back(start);
-    std::reverse(path.begin(), path.end());
     return path;
 }
 
+void PathFinder::prepare_scratch() {
+    const std::size_t cells = map_->width() * map_->height();
+    if (scratch_.visited_generation.size() != cells) {
+        scratch_.visited_generation.assign(cells, 0);
+        scratch_.came_from.resize(cells);
+        scratch_.frontier.resize(cells);
+        scratch_.goal_generation.assign(cells, 0);
+        scratch_.goal_rank.resize(cells);
+        scratch_.generation = 0;
+    }
+    if (++scratch_.generation == 0) {
+        std::fill(scratch_.visited_generation.begin(), scratch_.visited_generation.end(), 0);
+        std::fill(scratch_.goal_generation.begin(), scratch_.goal_generation.end(), 0);
+        scratch_.generation = 1;
+    }
+}
+
 } // namespace towerdefense
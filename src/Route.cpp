@@ -0,0 +1,88 @@
+#include "towerdefense/Route.hpp"
+
+#include <stdexcept>
+
+namespace towerdefense {
+
+namespace {
+enum Step : std::uint64_t {
+    East = 0,
+    West = 1,
+    South = 2,
+    North = 3,
+};
+
+bool encode_step(const GridPosition& from, const GridPosition& to, std::uint64_t& code) {
+    if (to.y == from.y && to.x == from.x + 1) {
+        code = East;
+    } else if (to.y == from.y && to.x + 1 == from.x) {
+        code = West;
+    } else if (to.x == from.x && to.y == from.y + 1) {
+        code = South;
+    } else if (to.x == from.x && to.y + 1 == from.y) {
+        code = North;
+    } else {
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+Route::Route(const std::vector<GridPosition>& positions) {
+    if (positions.empty()) {
+        throw std::invalid_argument("Route cannot be empty");
+    }
+    start_ = positions.front();
+    goal_ = positions.back();
+    size_ = positions.size();
+    steps_.assign((size_ - 1 + kStepsPerWord - 1) / kStepsPerWord, 0);
+    for (std::size_t i = 0; i + 1 < size_; ++i) {
+        std::uint64_t code = 0;
+        if (!encode_step(positions[i], positions[i + 1], code)) {
+            steps_.clear();
+            waypoints_ = positions;
+            return;
+        }
+        steps_[i / kStepsPerWord] |= code << (2 * (i % kStepsPerWord));
+    }
+}
+
+RouteHandle Route::from_positions(const std::vector<GridPosition>& positions) {
+    return std::make_shared<const Route>(positions);
+}
+
+GridPosition Route::next(const GridPosition& current, std::size_t index) const noexcept {
+    if (index + 1 >= size_) {
+        return goal_;
+    }
+    if (!waypoints_.empty()) {
+        return waypoints_[index + 1];
+    }
+    switch ((steps_[index / kStepsPerWord] >> (2 * (index % kStepsPerWord))) & 0x3u) {
+    case East:
+        return GridPosition{current.x + 1, current.y};
+    case West:
+        return GridPosition{current.x - 1, current.y};
+    case South:
+        return GridPosition{current.x, current.y + 1};
+    default:
+        return GridPosition{current.x, current.y - 1};
+    }
+}
+
+std::vector<GridPosition> Route::to_positions() const {
+    std::vector<GridPosition> positions;
+    positions.reserve(size_);
+    GridPosition current = start_;
+    for (std::size_t i = 0; i < size_; ++i) {
+        positions.push_back(current);
+        current = next(current, i);
+    }
+    return positions;
+}
+
+std::size_t Route::memory_footprint() const noexcept {
+    return sizeof(Route) + steps_.capacity() * sizeof(std::uint64_t) + waypoints_.capacity() * sizeof(GridPosition);
+}
+
+} // namespace towerdefense
@@ -0,0 +1,97 @@
+#include "towerdefense/TargetSelection.hpp"
+
+#include "towerdefense/CpuFeatures.hpp"
+
+#include <bit>
+
+namespace towerdefense {
+
+namespace {
+
+template <TargetingMode Mode>
+constexpr bool kPrefersSmaller = Mode == TargetingMode::Nearest || Mode == TargetingMode::Weakest;
+
+// Below this many keys the vector setup costs more than it saves.
+constexpr std::size_t kMinVectorKeys = 16;
+
+template <TargetingMode Mode>
+std::size_t select_scalar(const std::uint32_t* keys, const std::uint64_t* spawns, std::size_t count) noexcept {
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        if (outranks<Mode>(keys[i], spawns[i], keys[best], spawns[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#ifdef TOWERDEFENSE_X86_KERNELS
+
+// Bit k set when block[k] equals wanted.
+TOWERDEFENSE_TARGET_AVX2 unsigned match_mask(const std::uint32_t* block, __m256i wanted) noexcept {
+    const __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(keys, wanted))));
+}
+
+// Two passes over eight keys at a time: reduce to the winning key, then
+// settle ties among its matches by spawn sequence.
+template <TargetingMode Mode>
+TOWERDEFENSE_TARGET_AVX2 std::size_t select_avx2(
+    const std::uint32_t* keys, const std::uint64_t* spawns, std::size_t count) noexcept {
+    const std::size_t vector_end = count - count % 8;
+    __m256i folded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+    for (std::size_t i = 8; i < vector_end; i += 8) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        folded = kPrefersSmaller<Mode> ? _mm256_min_epu32(folded, block) : _mm256_max_epu32(folded, block);
+    }
+    alignas(32) std::uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), folded);
+    std::uint32_t best_key = lanes[0];
+    for (const std::uint32_t lane : lanes) {
+        best_key = kPrefersSmaller<Mode> ? std::min(best_key, lane) : std::max(best_key, lane);
+    }
+    for (std::size_t i = vector_end; i < count; ++i) {
+        best_key = kPrefersSmaller<Mode> ? std::min(best_key, keys[i]) : std::max(best_key, keys[i]);
+    }
+
+    constexpr std::size_t kNone = ~std::size_t{0};
+    std::size_t best = kNone;
+    auto settle = [&](std::size_t i) {
+        if (best == kNone || outranks<Mode>(best_key, spawns[i], best_key, spawns[best])) {
+            best = i;
+        }
+    };
+    const __m256i wanted = _mm256_set1_epi32(static_cast<int>(best_key));
+    for (std::size_t i = 0; i < vector_end; i += 8) {
+        for (unsigned mask = match_mask(keys + i, wanted); mask != 0; mask &= mask - 1) {
+            settle(i + static_cast<std::size_t>(std::countr_zero(mask)));
+        }
+    }
+    for (std::size_t i = vector_end; i < count; ++i) {
+        if (keys[i] == best_key) {
+            settle(i);
+        }
+    }
+    return best;
+}
+
+#endif
+
+} // namespace
+
+template <TargetingMode Mode>
+std::size_t select_best(const std::uint32_t* keys, const std::uint64_t* spawns, std::size_t count) noexcept {
+#ifdef TOWERDEFENSE_X86_KERNELS
+    if (count >= kMinVectorKeys && cpu_has_avx2()) {
+        return select_avx2<Mode>(keys, spawns, count);
+    }
+#endif
+    return select_scalar<Mode>(keys, spawns, count);
+}
+
+template std::size_t select_best<TargetingMode::Nearest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+template std::size_t select_best<TargetingMode::Farthest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+template std::size_t select_best<TargetingMode::Strongest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+template std::size_t select_best<TargetingMode::Weakest>(const std::uint32_t*, const std::uint64_t*, std::size_t) noexcept;
+
+} // namespace towerdefense
@@ -1,6 +1,8 @@
 #include "towerdefense/Tower.hpp"
 
-#include "towerdefense/Creature.hpp"
+#include "towerdefense/CreatureGrid.hpp"
+#include "towerdefense/CreatureStore.hpp"
+#include "towerdefense/TargetSelection.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -9,9 +11,10 @@
 
 namespace towerdefense {
 
-Tower::Tower(std::string id, std::string name, GridPosition position, TargetingMode targeting_mode,
+Tower::Tower(TowerKind kind, std::string id, std::string name, GridPosition position, TargetingMode targeting_mode,
     std::vector<TowerLevel> levels, std::string projectile_behavior)
-    : id_(std::move(id))
+    : kind_(kind)
+    , id_(std::move(id))
     , name_(std::move(name))
     , position_(position)
     , cost_(levels.empty() ? Materials{} : levels.front().build_cost)
@@ -59,90 +62,134 @@ Materials Tower::sell_value(double refund_ratio) const {
     return invested_materials_.scaled(refund_ratio);
 }
 
-std::vector<Creature*> Tower::targets_in_range(std::vector<Creature>& creatures) const {
-    std::vector<Creature*> result;
-    for (auto& creature : creatures) {
-        if (!creature.is_alive() || creature.has_exited()) {
-            continue;
-        }
-        if (distance(position_, creature.position()) <= range_) {
-            result.push_back(&creature);
-        }
+std::span<const std::size_t> Tower::targets_in_range(
+    const CreatureStore& creatures, const CreatureGrid& grid, TargetScratch& scratch) const {
+    if (!coverage_.is_built_for(range_)) {
+        return targets_in_radius(creatures, grid, position_, range_, scratch);
     }
-    return result;
-}
-
-std::vector<Creature*> Tower::targets_in_radius(
-    std::vector<Creature>& creatures, const GridPosition& origin, double radius) const {
-    std::vector<Creature*> result;
-    for (auto& creature : creatures) {
-        if (!creature.is_alive() || creature.has_exited()) {
-            continue;
+    auto& result = scratch.candidates;
+    result.clear();
+    for (const auto& cell : coverage_.by_distance()) {
+        for (const std::uint32_t index : grid.occupants(cell.cell)) {
+            if (creatures.is_alive(index)) {
+                result.push_back(index);
+            }
         }
-        if (distance(origin, creature.position()) <= radius) {
-            result.push_back(&creature);
+    }
+    for (const std::uint32_t index : grid.strays()) {
+        if (creatures.is_alive(index) && in_range(creatures.position(index))) {
+            result.push_back(index);
         }
     }
     return result;
 }
 
-Creature* Tower::select_target(std::vector<Creature*>& candidates) const {
-    return select_target(candidates, targeting_mode_);
+std::span<const std::size_t> Tower::targets_in_radius(const CreatureStore& creatures, const CreatureGrid& grid,
+    const GridPosition& origin, double radius, TargetScratch& scratch) const {
+    grid.query(creatures, origin, radius, scratch.candidates);
+    return scratch.candidates;
 }
 
-Creature* Tower::select_target(std::vector<Creature*>& candidates, TargetingMode mode) const {
+std::optional<std::size_t> Tower::select_target(const CreatureStore& creatures,
+    std::span<const std::size_t> candidates, TargetingMode mode, TargetScratch& scratch) const {
     if (candidates.empty()) {
-        return nullptr;
+        return std::nullopt;
     }
     switch (mode) {
-    case TargetingMode::Nearest: {
-        double best_distance = std::numeric_limits<double>::max();
-        Creature* best = nullptr;
-        for (auto* creature : candidates) {
-            const double d = distance(position_, creature->position());
-            if (d < best_distance) {
-                best_distance = d;
-                best = creature;
-            }
+    case TargetingMode::Nearest:
+        return pick_target<TargetingMode::Nearest>(creatures, candidates, scratch);
+    case TargetingMode::Farthest:
+        return pick_target<TargetingMode::Farthest>(creatures, candidates, scratch);
+    case TargetingMode::Strongest:
+        return pick_target<TargetingMode::Strongest>(creatures, candidates, scratch);
+    case TargetingMode::Weakest:
+        return pick_target<TargetingMode::Weakest>(creatures, candidates, scratch);
+    }
+    return candidates.front();
+}
+
+std::optional<std::size_t> Tower::acquire_target(
+    const CreatureStore& creatures, const CreatureGrid& grid, TargetingMode mode, TargetScratch& scratch) const {
+    if (coverage_.is_built_for(range_)) {
+        if (mode == TargetingMode::Nearest) {
+            return scan_coverage<TargetingMode::Nearest>(creatures, grid);
         }
-        return best;
-    }
-    case TargetingMode::Farthest: {
-        double best_distance = 0.0;
-        Creature* best = nullptr;
-        for (auto* creature : candidates) {
-            const double d = distance(position_, creature->position());
-            if (d >= best_distance) {
-                best_distance = d;
-                best = creature;
-            }
+        if (mode == TargetingMode::Farthest) {
+            return scan_coverage<TargetingMode::Farthest>(creatures, grid);
         }
-        return best;
-    }
-    case TargetingMode::Strongest: {
-        Creature* best = nullptr;
-        int best_health = -1;
-        for (auto* creature : candidates) {
-            if (creature->health() >= best_health) {
-                best_health = creature->health();
-                best = creature;
-            }
+    }
+    // The health modes have to see every creature in range, so they collect
+    // the candidates and leave the comparison to the select_best kernel.
+    return select_target(creatures, targets_in_range(creatures, grid, scratch), mode, scratch);
+}
+
+// Keeps a running best instead of collecting candidates. Nearest walks the
+// rings outwards and Farthest inwards, stopping once no ring can win.
+template <TargetingMode Mode>
+std::optional<std::size_t> Tower::scan_coverage(const CreatureStore& creatures, const CreatureGrid& grid) const {
+    static_assert(Mode == TargetingMode::Nearest || Mode == TargetingMode::Farthest);
+    constexpr bool kOutwards = Mode == TargetingMode::Nearest;
+    std::optional<std::uint32_t> best_key;
+    std::size_t best = 0;
+    auto consider = [&](std::size_t index, std::uint32_t key) {
+        if (!best_key
+            || outranks<Mode>(key, creatures.spawn_sequence(index), *best_key, creatures.spawn_sequence(best))) {
+            best_key = key;
+            best = index;
         }
-        return best;
-    }
-    case TargetingMode::Weakest: {
-        Creature* best = nullptr;
-        int best_health = std::numeric_limits<int>::max();
-        for (auto* creature : candidates) {
-            if (creature->health() <= best_health) {
-                best_health = creature->health();
-                best = creature;
+    };
+    // Strays first so their distance can end the ring walk early too.
+    for (const std::uint32_t index : grid.strays()) {
+        if (creatures.is_alive(index) && in_range(creatures.position(index))) {
+            consider(index, target_key<Mode>(creatures, index));
+        }
+    }
+    const auto cells = coverage_.by_distance();
+    for (std::size_t k = 0; k < cells.size(); ++k) {
+        const auto& cell = cells[kOutwards ? k : cells.size() - 1 - k];
+        // Every creature on a ring the best key outranks loses too.
+        if (best_key && outranks<Mode>(*best_key, 0, cell.squared_distance, 0)) {
+            break;
+        }
+        for (const std::uint32_t index : grid.occupants(cell.cell)) {
+            if (creatures.is_alive(index)) {
+                consider(index, cell.squared_distance);
             }
         }
-        return best;
     }
+    if (!best_key) {
+        return std::nullopt;
     }
-    return candidates.front();
+    return best;
+}
+
+bool Tower::in_range(const GridPosition& position) const noexcept {
+    const double dx = static_cast<double>(position.x) - static_cast<double>(position_.x);
+    const double dy = static_cast<double>(position.y) - static_cast<double>(position_.y);
+    return dx * dx + dy * dy <= range_ * range_;
+}
+
+template <TargetingMode Mode>
+std::uint32_t Tower::target_key(const CreatureStore& creatures, std::size_t index) const noexcept {
+    if constexpr (Mode == TargetingMode::Nearest || Mode == TargetingMode::Farthest) {
+        return squared_cell_distance(position_, creatures.position(index));
+    } else {
+        return static_cast<std::uint32_t>(std::max(0, creatures.health(index)));
+    }
+}
+
+template <TargetingMode Mode>
+std::size_t Tower::pick_target(
+    const CreatureStore& creatures, std::span<const std::size_t> candidates, TargetScratch& scratch) const {
+    auto& keys = scratch.keys;
+    auto& spawns = scratch.spawns;
+    keys.resize(candidates.size());
+    spawns.resize(candidates.size());
+    for (std::size_t k = 0; k < candidates.size(); ++k) {
+        keys[k] = target_key<Mode>(creatures, candidates[k]);
+        spawns[k] = creatures.spawn_sequence(candidates[k]);
+    }
+    return candidates[select_best<Mode>(keys.data(), spawns.data(), keys.size())];
 }
 
 void Tower::refresh_stats() {
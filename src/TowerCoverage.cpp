@@ -0,0 +1,41 @@
+#include "towerdefense/TowerCoverage.hpp"
+
+#include "towerdefense/Map.hpp"
+#include "towerdefense/TargetSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace towerdefense {
+
+void TowerCoverage::build(const Map& map, const GridPosition& origin, double range, std::size_t map_version) {
+    by_distance_.clear();
+    range_ = range;
+    map_version_ = map_version;
+    if (range < 0.0 || map.cell_count() == 0) {
+        return;
+    }
+
+    // Same squared test as CreatureGrid::query, so both agree on the edge.
+    const double limit = range * range;
+    const auto reach = static_cast<std::size_t>(std::ceil(range));
+    const std::size_t first_x = origin.x > reach ? origin.x - reach : 0;
+    const std::size_t last_x = std::min(origin.x + reach, map.width() - 1);
+    const std::size_t first_y = origin.y > reach ? origin.y - reach : 0;
+    const std::size_t last_y = std::min(origin.y + reach, map.height() - 1);
+    for (std::size_t y = first_y; y <= last_y; ++y) {
+        for (std::size_t x = first_x; x <= last_x; ++x) {
+            const GridPosition position{x, y};
+            const double dx = static_cast<double>(x) - static_cast<double>(origin.x);
+            const double dy = static_cast<double>(y) - static_cast<double>(origin.y);
+            if (dx * dx + dy * dy <= limit && map.is_walkable(position, true)) {
+                by_distance_.push_back(Cell{map.cell_id(position), squared_cell_distance(origin, position)});
+            }
+        }
+    }
+    // Pushed in cell order, so a stable sort keeps that order within a ring.
+    std::stable_sort(by_distance_.begin(), by_distance_.end(),
+        [](const Cell& lhs, const Cell& rhs) { return lhs.squared_distance < rhs.squared_distance; });
+}
+
+} // namespace towerdefense
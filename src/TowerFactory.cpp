@@ -1,7 +1,5 @@
 #include "towerdefense/TowerFactory.hpp"
 
-#include "towerdefense/Creature.hpp"
-
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
@@ -183,166 +181,37 @@ const TowerArchetype& require_archetype(std::string_view type) {
     return *it;
 }
 
-class BallistaTower : public Tower {
-public:
-    BallistaTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* target = select_target(candidates);
-        if (!target) {
-            return false;
-        }
-        int damage = damage_;
-        if (target->is_carrying_resource()) {
-            damage += std::max(1, damage_ / 2);
-        }
-        target->apply_damage(damage);
-        return true;
-    }
-};
-
-class MortarTower : public Tower {
-public:
-    MortarTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* primary = select_target(candidates);
-        if (!primary) {
-            return false;
-        }
-        // Mortar shells now focus on a single target (no splash).
-        primary->apply_damage(damage_);
-        return true;
-    }
-};
-
-class FrostspireTower : public Tower {
-public:
-    FrostspireTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* target = select_target(candidates);
-        if (!target) {
-            return false;
-        }
-        target->apply_damage(damage_);
-        const double slow_factor = 0.4;
-        const int duration = 2 + static_cast<int>(level_index());
-        target->apply_slow(slow_factor, duration);
-        return true;
-    }
-};
-
-class StormTotemTower : public Tower {
-public:
-    StormTotemTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* target = select_target(candidates);
-        if (!target) {
-            return false;
-        }
-        // Single-target lightning strike.
-        target->apply_damage(damage_);
-        return true;
-    }
-};
-
-class ArcanePrismTower : public Tower {
-public:
-    ArcanePrismTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* primary = select_target(candidates, TargetingMode::Strongest);
-        if (!primary) {
-            return false;
-        }
-        primary->apply_damage(damage_);
-        return true;
-    }
-};
-
-class TeslaCoilTower : public Tower {
-public:
-    TeslaCoilTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto victims = targets_in_range(creatures);
-        Creature* target = select_target(victims);
-        if (!target) {
-            return false;
-        }
-        // Single-target zap.
-        target->apply_damage(damage_);
-        return true;
-    }
-};
-
-class DruidGroveTower : public Tower {
-public:
-    DruidGroveTower(const TowerArchetype& archetype, const GridPosition& position)
-        : Tower(archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
-            archetype.projectile_behavior) {}
-
-    bool attack(std::vector<Creature>& creatures) override {
-        auto candidates = targets_in_range(creatures);
-        Creature* target = select_target(candidates, TargetingMode::Weakest);
-        if (!target) {
-            return false;
-        }
-        target->apply_damage(damage_);
-        target->apply_slow(0.6, 2 + static_cast<int>(level_index()));
-        return true;
-    }
-};
-
-TowerPtr instantiate(const TowerArchetype& archetype, const GridPosition& position) {
+TowerKind kind_of(const TowerArchetype& archetype) {
     if (archetype.id == "ballista") {
-        return std::make_unique<BallistaTower>(archetype, position);
+        return TowerKind::Ballista;
     }
     if (archetype.id == "mortar") {
-        return std::make_unique<MortarTower>(archetype, position);
+        return TowerKind::Mortar;
     }
     if (archetype.id == "frostspire") {
-        return std::make_unique<FrostspireTower>(archetype, position);
+        return TowerKind::Frostspire;
     }
     if (archetype.id == "storm_totem") {
-        return std::make_unique<StormTotemTower>(archetype, position);
+        return TowerKind::StormTotem;
     }
     if (archetype.id == "arcane_prism") {
-        return std::make_unique<ArcanePrismTower>(archetype, position);
+        return TowerKind::ArcanePrism;
     }
     if (archetype.id == "tesla_coil") {
-        return std::make_unique<TeslaCoilTower>(archetype, position);
+        return TowerKind::TeslaCoil;
     }
     if (archetype.id == "druid_grove") {
-        return std::make_unique<DruidGroveTower>(archetype, position);
+        return TowerKind::DruidGrove;
     }
     throw std::invalid_argument("Unsupported tower archetype: " + archetype.id);
 }
 
 } // namespace
 
-TowerPtr TowerFactory::create(std::string_view type, const GridPosition& position) {
+Tower TowerFactory::create(std::string_view type, const GridPosition& position) {
     const auto& archetype = require_archetype(type);
-    return instantiate(archetype, position);
+    return Tower{kind_of(archetype), archetype.id, archetype.name, position, archetype.targeting_mode, archetype.levels,
+        archetype.projectile_behavior};
 }
 
 Materials TowerFactory::cost(std::string_view type) {
@@ -0,0 +1,136 @@
+#include "towerdefense/TowerStore.hpp"
+
+#include "towerdefense/CreatureGrid.hpp"
+#include "towerdefense/CreatureStore.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace towerdefense {
+
+TowerHandle TowerStore::insert(Tower tower) {
+    const auto kind = static_cast<std::size_t>(tower.kind());
+    std::uint32_t slot = 0;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        if (slots_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Too many towers");
+        }
+        slot = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+        // Keeps erase() from failing halfway on a free-list allocation.
+        free_slots_.reserve(slots_.capacity());
+    }
+    towers_[kind].push_back(std::move(tower));
+    owners_[kind].push_back(slot);
+    slots_[slot].position = static_cast<std::uint32_t>(towers_[kind].size() - 1);
+    slots_[slot].kind = static_cast<TowerKind>(kind);
+    return handle(slot);
+}
+
+bool TowerStore::erase(TowerHandle handle) {
+    if (find(handle) == nullptr) {
+        return false;
+    }
+    Slot& slot = slots_[handle.index];
+    const auto kind = static_cast<std::size_t>(slot.kind);
+    auto& towers = towers_[kind];
+    auto& owners = owners_[kind];
+    const std::size_t last = towers.size() - 1;
+    if (slot.position != last) {
+        towers[slot.position] = std::move(towers[last]);
+        owners[slot.position] = owners[last];
+        slots_[owners[slot.position]].position = slot.position;
+    }
+    towers.pop_back();
+    owners.pop_back();
+    slot.position = kVacant;
+    ++slot.generation;
+    free_slots_.push_back(handle.index);
+    return true;
+}
+
+Tower* TowerStore::find(TowerHandle handle) noexcept {
+    return const_cast<Tower*>(std::as_const(*this).find(handle));
+}
+
+const Tower* TowerStore::find(TowerHandle handle) const noexcept {
+    if (handle.index >= slots_.size()) {
+        return nullptr;
+    }
+    const Slot& slot = slots_[handle.index];
+    if (slot.position == kVacant || slot.generation != handle.generation) {
+        return nullptr;
+    }
+    return &towers_[static_cast<std::size_t>(slot.kind)][slot.position];
+}
+
+void TowerStore::refresh_coverage(const Map& map, std::size_t map_version) {
+    for (auto& towers : towers_) {
+        for (auto& tower : towers) {
+            if (!tower.coverage_.is_current(map_version, tower.range_)) {
+                tower.coverage_.build(map, tower.position_, tower.range_, map_version);
+            }
+        }
+    }
+}
+
+// Every kind acquires, selects and damages one target; the kinds differ in
+// targeting overrides and on-hit effects.
+template <TowerKind Kind>
+bool TowerStore::fire(Tower& tower, CreatureStore& creatures, const CreatureGrid& grid, TargetScratch& scratch) {
+    TargetingMode mode = tower.targeting_mode_;
+    if constexpr (Kind == TowerKind::ArcanePrism) {
+        mode = TargetingMode::Strongest;
+    } else if constexpr (Kind == TowerKind::DruidGrove) {
+        mode = TargetingMode::Weakest;
+    }
+    const auto target = tower.acquire_target(creatures, grid, mode, scratch);
+    if (!target) {
+        return false;
+    }
+
+    int damage = tower.damage_;
+    if constexpr (Kind == TowerKind::Ballista) {
+        if (creatures.is_carrying_resource(*target)) {
+            damage += std::max(1, tower.damage_ / 2);
+        }
+    }
+    creatures.apply_damage(*target, damage);
+
+    if constexpr (Kind == TowerKind::Frostspire) {
+        creatures.apply_slow(*target, 0.4, 2 + static_cast<int>(tower.level_index()));
+    } else if constexpr (Kind == TowerKind::DruidGrove) {
+        creatures.apply_slow(*target, 0.6, 2 + static_cast<int>(tower.level_index()));
+    }
+    return true;
+}
+
+template <TowerKind Kind>
+void TowerStore::attack_kind(CreatureStore& creatures, const CreatureGrid& grid) {
+    for (auto& tower : towers_[static_cast<std::size_t>(Kind)]) {
+        tower.tick();
+        if (!tower.can_attack()) {
+            continue;
+        }
+        if (fire<Kind>(tower, creatures, grid, scratch_)) {
+            tower.reset_cooldown();
+        }
+    }
+}
+
+void TowerStore::attack_all(CreatureStore& creatures, const CreatureGrid& grid) {
+    attack_kind<TowerKind::Ballista>(creatures, grid);
+    attack_kind<TowerKind::Mortar>(creatures, grid);
+    attack_kind<TowerKind::Frostspire>(creatures, grid);
+    attack_kind<TowerKind::StormTotem>(creatures, grid);
+    attack_kind<TowerKind::ArcanePrism>(creatures, grid);
+    attack_kind<TowerKind::TeslaCoil>(creatures, grid);
+    attack_kind<TowerKind::DruidGrove>(creatures, grid);
+}
+
+} // namespace towerdefense
@@ -1,4 +1,5 @@
 #include "towerdefense/WaveManager.hpp"
+#include "towerdefense/BehaviorRegistry.hpp"
 
 #include "towerdefense/Game.hpp"
 #include "towerdefense/Wave.hpp"
@@ -9,6 +10,7 @@
 #include <filesystem>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <optional>
 #include <random>
 #include <sstream>
@@ -394,18 +396,20 @@ Materials scale_materials(const Materials& base, double multiplier) {
     return Materials{scale(base.wood()), scale(base.stone()), scale(base.crystal())};
 }
 
-Creature build_creature_from_group(
-    const CreatureBlueprint& blueprint, const EnemyGroupDefinition& group, double wave_reward_multiplier) {
-    const int health = std::max(1, static_cast<int>(std::llround(static_cast<double>(blueprint.max_health) * group.health_modifier)));
-    const double speed = std::max(0.1, blueprint.speed * group.speed_modifier);
-    const Materials reward = scale_materials(blueprint.reward, wave_reward_multiplier * group.reward_modifier);
-    const int armor = blueprint.armor + group.armor_bonus;
-    const int shield = blueprint.shield + group.shield_bonus;
-    const bool flying = group.flying_override.value_or(blueprint.flying);
-    std::vector<std::string> behaviors = blueprint.behaviors;
-    behaviors.insert(behaviors.end(), group.extra_behaviors.begin(), group.extra_behaviors.end());
-    Creature creature{blueprint.id, blueprint.name, health, speed, reward, armor, shield, flying, behaviors};
-    return creature;
+// Applies a group's modifiers once; every creature in the group shares the
+// resulting blueprint.
+BlueprintHandle build_group_blueprint(
+    const CreatureBlueprint& base, const EnemyGroupDefinition& group, double wave_reward_multiplier) {
+    auto blueprint = std::make_shared<CreatureBlueprint>(base);
+    blueprint->max_health = std::max(1, static_cast<int>(std::llround(static_cast<double>(base.max_health) * group.health_modifier)));
+    blueprint->speed = std::max(0.1, base.speed * group.speed_modifier);
+    blueprint->reward = scale_materials(base.reward, wave_reward_multiplier * group.reward_modifier);
+    blueprint->armor = std::max(0, base.armor + group.armor_bonus);
+    blueprint->shield = std::max(0, base.shield + group.shield_bonus);
+    blueprint->flying = group.flying_override.value_or(base.flying);
+    blueprint->behaviors.insert(blueprint->behaviors.end(), group.extra_behaviors.begin(), group.extra_behaviors.end());
+    blueprint->behavior_mask |= BehaviorRegistry::intern(group.extra_behaviors);
+    return blueprint;
 }
 
 } // namespace
@@ -479,10 +483,10 @@ const WaveDefinition* WaveManager::queue_next_wave(Game& game) {
             if (creature_it == creatures_.end()) {
                 continue;
             }
+            const BlueprintHandle blueprint = build_group_blueprint(*creature_it->second, group, definition.reward_multiplier);
             const int count = std::max(1, group.count);
             for (int i = 0; i < count; ++i) {
-                Creature creature = build_creature_from_group(creature_it->second, group, definition.reward_multiplier);
-                pool.emplace_back(std::move(creature), group.spawn_interval_override);
+                pool.emplace_back(Creature{blueprint}, group.spawn_interval_override);
             }
         }
 
@@ -544,20 +548,23 @@ void WaveManager::load_from_file(const std::filesystem::path& file_path) {
     if (const JsonValue* creatures_node = find_member(root_object, "creatures")) {
         for (const auto& entry : creatures_node->as_array()) {
             const auto& creature_obj = entry.as_object();
-            CreatureBlueprint blueprint;
-            blueprint.id = get_string(creature_obj, "id", "");
-            if (blueprint.id.empty()) {
+            auto blueprint = std::make_shared<CreatureBlueprint>();
+            blueprint->id = get_string(creature_obj, "id", "");
+            if (blueprint->id.empty()) {
                 continue;
             }
-            blueprint.name = get_string(creature_obj, "name", blueprint.id);
-            blueprint.max_health = std::max(1, get_int(creature_obj, "health", 1));
-            blueprint.speed = std::max(0.1, get_double(creature_obj, "speed", 1.0));
-            blueprint.reward = parse_materials(creature_obj, "reward");
-            blueprint.armor = std::max(0, get_int(creature_obj, "armor", 0));
-            blueprint.shield = std::max(0, get_int(creature_obj, "shield", 0));
-            blueprint.flying = get_bool(creature_obj, "flying", false);
-            blueprint.behaviors = get_string_array(creature_obj, "behaviors");
-            creatures_[blueprint.id] = blueprint;
+            blueprint->name = get_string(creature_obj, "name", blueprint->id);
+            blueprint->max_health = std::max(1, get_int(creature_obj, "health", 1));
+            blueprint->speed = std::max(0.1, get_double(creature_obj, "speed", 1.0));
+            blueprint->reward = parse_materials(creature_obj, "reward");
+            blueprint->armor = std::max(0, get_int(creature_obj, "armor", 0));
+            blueprint->shield = std::max(0, get_int(creature_obj, "shield", 0));
+            blueprint->flying = get_bool(creature_obj, "flying", false);
+            blueprint->behaviors = get_string_array(creature_obj, "behaviors");
+            // Interned here so a file with too many behaviors fails to load
+            // instead of failing on spawn.
+            blueprint->behavior_mask = BehaviorRegistry::intern(blueprint->behaviors);
+            creatures_[blueprint->id] = std::move(blueprint);
         }
     }
 
@@ -580,7 +587,7 @@ void WaveManager::load_from_file(const std::filesystem::path& file_path) {
                         continue;
                     }
                     if (const auto creature_it = creatures_.find(group.creature_id); creature_it != creatures_.end()) {
-                        group.creature_name = creature_it->second.name;
+                        group.creature_name = creature_it->second->name;
                     } else {
                         group.creature_name = group.creature_id;
                     }
@@ -593,6 +600,7 @@ void WaveManager::load_from_file(const std::filesystem::path& file_path) {
                     group.spawn_interval_override = get_optional_int(group_obj, "spawn_interval");
                     group.flying_override = get_optional_bool(group_obj, "flying_override");
                     group.extra_behaviors = get_string_array(group_obj, "extra_behaviors");
+                    BehaviorRegistry::intern(group.extra_behaviors);
                     definition.groups.push_back(std::move(group));
                 }
             }
@@ -605,7 +613,7 @@ void WaveManager::load_from_file(const std::filesystem::path& file_path) {
     if (!waves_.empty() && waves_.size() < 2 && !creatures_.empty()) {
         EnemyGroupDefinition filler;
         filler.creature_id = creatures_.begin()->first;
-        filler.creature_name = creatures_.begin()->second.name;
+        filler.creature_name = creatures_.begin()->second->name;
         filler.count = 4;
         waves_.push_back(build_default_wave("Reinforcements", {filler}, 2));
     }
@@ -619,16 +627,16 @@ void WaveManager::load_default_definitions() {
     auto brute = build_default_creature("brute", "Orc Brute", 28, 0.65, Materials{0, 1, 0}, 2, 0, false, {"stubborn"});
     auto wyvern = build_default_creature("wyvern", "Wyvern", 26, 1.15, Materials{0, 0, 1}, 0, 4, true, {"flying", "arcane"});
 
-    creatures_.emplace(goblin.id, goblin);
-    creatures_.emplace(brute.id, brute);
-    creatures_.emplace(wyvern.id, wyvern);
+    creatures_.emplace(goblin->id, goblin);
+    creatures_.emplace(brute->id, brute);
+    creatures_.emplace(wyvern->id, wyvern);
 
     const auto make_group = [this](const std::string& id, int count, double health_mod = 1.0, double speed_mod = 1.0,
                                    std::optional<int> interval = std::nullopt) {
         EnemyGroupDefinition group;
         group.creature_id = id;
         if (const auto it = creatures_.find(id); it != creatures_.end()) {
-            group.creature_name = it->second.name;
+            group.creature_name = it->second->name;
         } else {
             group.creature_name = id;
         }
@@ -644,18 +652,19 @@ void WaveManager::load_default_definitions() {
     waves_.push_back(build_default_wave("Sky Hunters", {make_group("wyvern", 6, 1.1, 1.1, 2)}, 1, 1));
 }
 
-CreatureBlueprint WaveManager::build_default_creature(std::string id, std::string name, int health, double speed, Materials reward,
+BlueprintHandle WaveManager::build_default_creature(std::string id, std::string name, int health, double speed, Materials reward,
     int armor, int shield, bool flying, std::vector<std::string> behaviors) {
-    CreatureBlueprint blueprint;
-    blueprint.id = std::move(id);
-    blueprint.name = std::move(name);
-    blueprint.max_health = health;
-    blueprint.speed = speed;
-    blueprint.reward = std::move(reward);
-    blueprint.armor = armor;
-    blueprint.shield = shield;
-    blueprint.flying = flying;
-    blueprint.behaviors = std::move(behaviors);
+    auto blueprint = std::make_shared<CreatureBlueprint>();
+    blueprint->id = std::move(id);
+    blueprint->name = std::move(name);
+    blueprint->max_health = health;
+    blueprint->speed = speed;
+    blueprint->reward = std::move(reward);
+    blueprint->armor = armor;
+    blueprint->shield = shield;
+    blueprint->flying = flying;
+    blueprint->behavior_mask = BehaviorRegistry::intern(behaviors);
+    blueprint->behaviors = std::move(behaviors);
     return blueprint;
 }
 
@@ -0,0 +1,102 @@
+#include "towerdefense/WorkerPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace towerdefense {
+
+WorkerPool::WorkerPool(std::size_t worker_count)
+    : worker_count_(worker_count) {
+    if (worker_count_ == 0) {
+        worker_count_ = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::parallel_for(std::size_t count, std::size_t min_chunk, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+    // Aim for a few chunks per worker so uneven items still balance out.
+    const std::size_t chunk = std::max<std::size_t>(
+        std::max<std::size_t>(1, min_chunk), (count + worker_count_ * 4 - 1) / (worker_count_ * 4));
+    if (worker_count_ == 1 || count <= chunk) {
+        task(0, count, 0);
+        return;
+    }
+    if (threads_.empty()) {
+        start_threads();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    chunk_ = chunk;
+    next_chunk_ = 0;
+    error_ = nullptr;
+    ++job_;
+    wake_.notify_all();
+    drain(lock, 0);
+    done_.wait(lock, [this] { return next_chunk_ >= count_ && active_ == 0; });
+    task_ = nullptr;
+    count_ = 0;
+    if (auto error = std::exchange(error_, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::start_threads() {
+    threads_.reserve(worker_count_ - 1);
+    for (std::size_t worker = 1; worker < worker_count_; ++worker) {
+        threads_.emplace_back([this, worker] { worker_loop(worker); });
+    }
+}
+
+void WorkerPool::worker_loop(std::size_t worker) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::size_t seen_job = job_;
+    while (true) {
+        wake_.wait(lock, [&] { return stopping_ || job_ != seen_job; });
+        if (stopping_) {
+            return;
+        }
+        seen_job = job_;
+        drain(lock, worker);
+    }
+}
+
+void WorkerPool::drain(std::unique_lock<std::mutex>& lock, std::size_t worker) {
+    while (next_chunk_ < count_) {
+        const std::size_t begin = next_chunk_;
+        const std::size_t end = std::min(begin + chunk_, count_);
+        next_chunk_ = end;
+        ++active_;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            (*task_)(begin, end, worker);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        --active_;
+        if (error && !error_) {
+            error_ = error;
+        }
+    }
+    if (active_ == 0) {
+        done_.notify_all();
+    }
+}
+
+} // namespace towerdefense
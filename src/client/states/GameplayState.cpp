@@ -4,7 +4,7 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
-#include "towerdefense/Creature.hpp"
+#include "towerdefense/CreatureStore.hpp"
 #include "towerdefense/Tower.hpp"
 #include "towerdefense/TowerFactory.hpp"
 #include "towerdefense/WaveManager.hpp"
@@ -213,7 +213,7 @@ sf::Color make_color(const std::array<int, 3>& rgb) {
     return sf::Color(clamp_component(rgb[0]), clamp_component(rgb[1]), clamp_component(rgb[2]));
 }
 
-sf::Color creature_color(const towerdefense::Creature& creature) {
+sf::Color creature_color(const towerdefense::CreatureStore::ConstRef& creature) {
     const std::string& id = creature.id();
     if (id == "goblin") {
         return sf::Color(140, 200, 140);
@@ -405,11 +405,8 @@ void GameplayState::update(const sf::Time& delta_time) {
         const auto& towers = game->towers();
         const auto& creatures = game->creatures();
 
-        for (const auto& tower_ptr : towers) {
-            if (!tower_ptr) {
-                continue;
-            }
-            const auto* tower = tower_ptr.get();
+        for (const auto& tower_ref : towers) {
+            const auto* tower = &tower_ref;
             if (!tower->can_attack()) {
                 continue;
             }
@@ -417,7 +414,7 @@ void GameplayState::update(const sf::Time& delta_time) {
             const auto& tower_pos = tower->position();
             const double range = tower->range();
 
-            const towerdefense::Creature* best_target = nullptr;
+            std::optional<std::size_t> best_target;
             double best_distance = std::numeric_limits<double>::max();
 
             for (const auto& creature : creatures) {
@@ -427,7 +424,7 @@ void GameplayState::update(const sf::Time& delta_time) {
                 const double d = towerdefense::distance(tower_pos, creature.position());
                 if (d <= range && d < best_distance) {
                     best_distance = d;
-                    best_target = &creature;
+                    best_target = creature.index();
                 }
             }
 
@@ -439,7 +436,7 @@ void GameplayState::update(const sf::Time& delta_time) {
             const sf::Vector2f from{
                 map_origin_.x + (static_cast<float>(tower_pos.x) + 0.5f) * tile_size,
                 map_origin_.y + (static_cast<float>(tower_pos.y) + 0.5f) * tile_size};
-            auto interp = best_target->interpolated_position();
+            auto interp = creatures.interpolated_position(*best_target);
             const sf::Vector2f to{
                 map_origin_.x + (static_cast<float>(interp.first) + 0.5f) * tile_size,
                 map_origin_.y + (static_cast<float>(interp.second) + 0.5f) * tile_size};
@@ -954,14 +951,11 @@ void GameplayState::draw_map(sf::RenderTarget& target) {
     const auto& map = game->map();
     const sf::Vector2f tile_size(tile_size_, tile_size_);
     sf::RectangleShape tile(tile_size);
-    for (std::size_t y = 0; y < map.height(); ++y) {
-        for (std::size_t x = 0; x < map.width(); ++x) {
-            tile.setPosition(map_origin_.x + static_cast<float>(x) * tile_size_, map_origin_.y + static_cast<float>(y) * tile_size_);
-            const auto tile_type = map.at(towerdefense::GridPosition{x, y});
-            tile.setFillColor(tile_color(tile_type));
-            target.draw(tile);
-        }
-    }
+    map.for_each_cell([&](const towerdefense::GridPosition& pos, towerdefense::TileType tile_type) {
+        tile.setPosition(map_origin_.x + static_cast<float>(pos.x) * tile_size_, map_origin_.y + static_cast<float>(pos.y) * tile_size_);
+        tile.setFillColor(tile_color(tile_type));
+        target.draw(tile);
+    });
 
     if (!current_path_.empty()) {
         sf::RectangleShape step({tile_size_, tile_size_});
@@ -1016,14 +1010,11 @@ void GameplayState::draw_map(sf::RenderTarget& target) {
     target.draw(crystal_glow);
 
     for (const auto& tower : game->towers()) {
-        if (!tower) {
-            continue;
-        }
         const sf::Vector2f center{
-            map_origin_.x + (static_cast<float>(tower->position().x) + 0.5f) * tile_size_,
-            map_origin_.y + (static_cast<float>(tower->position().y) + 0.5f) * tile_size_,
+            map_origin_.x + (static_cast<float>(tower.position().x) + 0.5f) * tile_size_,
+            map_origin_.y + (static_cast<float>(tower.position().y) + 0.5f) * tile_size_,
         };
-        draw_tower_shape(target, *tower, center, tile_size_, simulation_time_);
+        draw_tower_shape(target, tower, center, tile_size_, simulation_time_);
     }
 
     const float base_creature_radius = tile_size_ / 2.f;
@@ -172,18 +172,14 @@ void MapGeneratorState::render(sf::RenderTarget& target) {
 }
 
 void MapGeneratorState::draw_map(sf::RenderTarget& target) const {
-    const std::size_t width = map_.width();
-    const std::size_t height = map_.height();
     sf::RectangleShape tile({tile_size_, tile_size_});
-    for (std::size_t y = 0; y < height; ++y) {
-        for (std::size_t x = 0; x < width; ++x) {
-            tile.setPosition(map_origin_.x + static_cast<float>(x) * tile_size_, map_origin_.y + static_cast<float>(y) * tile_size_);
-            tile.setFillColor(tile_color(map_.at(towerdefense::GridPosition{x, y})));
-            tile.setOutlineThickness(1.f);
-            tile.setOutlineColor(sf::Color(20, 20, 20, 80));
-            target.draw(tile);
-        }
-    }
+    tile.setOutlineThickness(1.f);
+    tile.setOutlineColor(sf::Color(20, 20, 20, 80));
+    map_.for_each_cell([&](const towerdefense::GridPosition& pos, towerdefense::TileType type) {
+        tile.setPosition(map_origin_.x + static_cast<float>(pos.x) * tile_size_, map_origin_.y + static_cast<float>(pos.y) * tile_size_);
+        tile.setFillColor(tile_color(type));
+        target.draw(tile);
+    });
 }
 
 } // namespace client
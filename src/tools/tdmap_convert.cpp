@@ -0,0 +1,34 @@
+#include "towerdefense/Map.hpp"
+#include "towerdefense/MapBundle.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+using namespace towerdefense;
+
+// Converts text maps into .tdmap bundles. Each input is loaded exactly as the
+// game would load it, so the bundle stores the prepared map.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: tdmap-convert <map.txt> [output.tdmap]\n"
+                  << "       tdmap-convert <map.txt>... (writes each next to its source)\n";
+        return 1;
+    }
+    try {
+        if (argc == 3 && std::filesystem::path{argv[2]}.extension() == MapBundle::kExtension) {
+            MapBundle::write(Map::load_from_file(argv[1]), argv[2]);
+            std::cout << argv[1] << " -> " << argv[2] << '\n';
+            return 0;
+        }
+        for (int i = 1; i < argc; ++i) {
+            std::filesystem::path output{argv[i]};
+            output.replace_extension(MapBundle::kExtension);
+            MapBundle::write(Map::load_from_file(argv[i]), output);
+            std::cout << argv[i] << " -> " << output.string() << '\n';
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "towerdefense/Map.hpp"
+#include "towerdefense/MapBundle.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace towerdefense;
+
+namespace {
+
+// Byte offsets of the header's section fields, see MapBundle.cpp.
+constexpr std::size_t kEntryCountField = 24;
+constexpr std::size_t kTilesOffsetField = 48;
+constexpr std::size_t kResourceFieldOffsetField = 72;
+constexpr std::size_t kExitFieldOffsetField = 80;
+
+std::vector<char> read_bytes(const std::filesystem::path& path) {
+    std::ifstream in{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+void write_bytes(const std::filesystem::path& path, const std::vector<char>& bytes) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <typename T>
+T field(const std::vector<char>& bytes, std::size_t offset) {
+    T value{};
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void set_field(std::vector<char>& bytes, std::size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// Loads bytes as a bundle and reports whether it was rejected as corrupt.
+bool rejected_as_corrupt(const std::filesystem::path& path, const std::vector<char>& bytes) {
+    write_bytes(path, bytes);
+    try {
+        (void)MapBundle::load(path);
+    } catch (const std::runtime_error& ex) {
+        return std::string{ex.what()}.rfind("Map bundle is corrupt", 0) == 0;
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto good = directory / "towerdefense_bundle_test.tdmap";
+    const auto bad = directory / "towerdefense_bundle_test_corrupt.tdmap";
+    const Map map = Map::from_lines({
+        "............",
+        "E######.....",
+        "...#..#####X",
+        "...#..#.....",
+        "...#######..",
+        "......#.....",
+        "..####R###..",
+    });
+    MapBundle::write(map, good);
+    const Map loaded = MapBundle::load(good);
+    int failures = 0;
+    if (loaded.width() != map.width() || loaded.height() != map.height()) {
+        std::cerr << "round trip changed the map size\n";
+        ++failures;
+    }
+
+    const std::vector<char> original = read_bytes(good);
+    const std::uint64_t cells = static_cast<std::uint64_t>(map.width()) * map.height();
+    const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    struct Corruption {
+        const char* name;
+        std::size_t offset;
+        std::uint64_t value;
+    };
+    const Corruption corruptions[] = {
+        {"tiles offset wrapping to zero", kTilesOffsetField, max - cells + 1},
+        {"tiles offset inside the header", kTilesOffsetField, 0},
+        {"exit field offset wrapping", kExitFieldOffsetField, max - cells * 4 + 1},
+        {"sections out of order", kResourceFieldOffsetField, field<std::uint64_t>(original, kExitFieldOffsetField) + 8},
+    };
+    for (const auto& corruption : corruptions) {
+        auto bytes = original;
+        set_field(bytes, corruption.offset, corruption.value);
+        if (!rejected_as_corrupt(bad, bytes)) {
+            std::cerr << "not rejected: " << corruption.name << '\n';
+            ++failures;
+        }
+    }
+    auto bytes = original;
+    set_field<std::uint32_t>(bytes, kEntryCountField, std::numeric_limits<std::uint32_t>::max());
+    if (!rejected_as_corrupt(bad, bytes)) {
+        std::cerr << "not rejected: entry count past the end\n";
+        ++failures;
+    }
+
+
+    // Distance fields are walked as stored, so a far too large step count at
+    // an entry or one with no downhill neighbour must not load.
+    const auto resource_field = field<std::uint64_t>(original, kResourceFieldOffsetField);
+    const std::size_t entry_cell = map.entries().front().y * map.width() + map.entries().front().x;
+    for (const std::uint32_t distance : {std::uint32_t{0x7FFFFFFF}, static_cast<std::uint32_t>(cells - 1)}) {
+        bytes = original;
+        set_field(bytes, resource_field + entry_cell * sizeof(std::uint32_t), distance);
+        if (!rejected_as_corrupt(bad, bytes)) {
+            std::cerr << "not rejected: resource distance " << distance << " at an entry\n";
+            ++failures;
+        }
+    }
+
+    std::filesystem::remove(good);
+    std::filesystem::remove(bad);
+    return failures == 0 ? 0 : 1;
+}